@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "wt9011_assembler.h"
+#include "wt9011_decoder.h"
+#include "wt9011_test.h"
+
+// Frames split at every chunk size, with garbage between them: no 0x55 at all,
+// a 0x55 followed by an unknown frame type, and a lone byte
+WT9011_TEST(assembler) {
+    std::vector<std::vector<std::uint8_t>> frames;
+    for (int i = 0; i < 3; ++i) {
+        SensorData data;
+        data.accel = { 0.25f * i, -1.0f, 1.0f };
+        data.gyro = { 10.0f * i, 20.0f, -30.0f };
+        data.angle = { 1.0f, -2.0f, 45.0f * i };
+        std::vector<std::uint8_t> frame(wt9011::kFrameSize);
+        wt9011::encode_frame(data, frame.data());
+        frames.push_back(frame);
+    }
+    const std::vector<std::uint8_t> garbage[] = { { 0x00, 0x13 }, { 0x55, 0x00 }, { 0xAA } };
+    std::vector<std::uint8_t> stream;
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        stream.insert(stream.end(), garbage[i].begin(), garbage[i].end());
+        stream.insert(stream.end(), frames[i].begin(), frames[i].end());
+    }
+    const std::size_t garbage_bytes = stream.size() - frames.size() * wt9011::kFrameSize;
+
+    for (std::size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+        wt9011::FrameAssembler assembler;
+        std::vector<std::vector<std::uint8_t>> out;
+        for (std::size_t offset = 0; offset < stream.size(); offset += chunk) {
+            const std::size_t length = std::min(chunk, stream.size() - offset);
+            assembler.feed(stream.data() + offset, length, [&out](const std::uint8_t* frame) {
+                out.emplace_back(frame, frame + wt9011::kFrameSize);
+            });
+        }
+        CHECK(out == frames);
+        CHECK(assembler.frames() == frames.size());
+        CHECK(assembler.discarded_bytes() == garbage_bytes);
+        CHECK(assembler.resyncs() >= 3);
+    }
+
+    // Several frames in one notification
+    wt9011::FrameAssembler assembler;
+    std::size_t emitted = 0;
+    auto count = [&emitted](const std::uint8_t*) { ++emitted; };
+    std::vector<std::uint8_t> joined;
+    for (const auto& frame : frames) {
+        joined.insert(joined.end(), frame.begin(), frame.end());
+    }
+    CHECK(assembler.feed(joined.data(), joined.size(), count) == frames.size());
+
+    // A partial frame is dropped on reset
+    emitted = 0;
+    CHECK(assembler.pending() == 0);
+    assembler.feed(frames[0].data(), 7, count);
+    CHECK(assembler.pending() == 7);
+    assembler.reset();
+    CHECK(assembler.pending() == 0);
+    assembler.feed(frames[1].data(), frames[1].size(), count);
+    CHECK(emitted == 1);
+    CHECK(assembler.discarded_bytes() == 0);
+}
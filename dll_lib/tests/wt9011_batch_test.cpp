@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "wt9011_batch.h"
+#include "wt9011_test.h"
+
+namespace {
+
+struct SoaBuffer {
+    explicit SoaBuffer(std::size_t count) : values(9 * count, -1.0f), count(count) {}
+
+    SensorDataSoA soa() {
+        float* p = values.data();
+        return { p, p + count, p + 2 * count, p + 3 * count, p + 4 * count, p + 5 * count,
+                 p + 6 * count, p + 7 * count, p + 8 * count };
+    }
+
+    std::vector<float> values;
+    std::size_t count;
+};
+
+} // namespace
+
+// The vector decoders must match the scalar one exactly, including the tail
+// that does not fill a vector and the ends of the int16 range
+WT9011_TEST(batch) {
+    constexpr std::size_t kFrames = 37;
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> raw(-32768, 32767);
+    std::vector<std::uint8_t> frames(kFrames * wt9011::kFrameSize);
+    for (std::size_t i = 0; i < kFrames; ++i) {
+        std::uint8_t* f = frames.data() + i * wt9011::kFrameSize;
+        f[0] = wt9011::kFrameHeader;
+        f[1] = wt9011::kFrameTypeData;
+        for (int c = 0; c < 9; ++c) {
+            wt9011::write_i16(f + 2 + 2 * c, static_cast<std::int16_t>(i == 3 ? 32767 : i == 4 ? -32768 : raw(rng)));
+        }
+    }
+
+    SoaBuffer scalar(kFrames);
+    wt9011::decode_frames_scalar(frames.data(), kFrames, scalar.soa());
+    for (std::size_t i = 0; i < kFrames; ++i) {
+        SensorData data;
+        CHECK(wt9011::decode_frame(frames.data() + i * wt9011::kFrameSize, wt9011::kFrameSize, data));
+        CHECK(scalar.soa().ax[i] == data.accel.x && scalar.soa().gz[i] == data.gyro.z &&
+              scalar.soa().yaw[i] == data.angle.yaw);
+    }
+
+#if defined(WT9011_HAVE_SSE2)
+    SoaBuffer sse2(kFrames);
+    wt9011::decode_frames_sse2(frames.data(), kFrames, sse2.soa());
+    CHECK(sse2.values == scalar.values);
+    if (wt9011::cpu_has_avx2()) {
+        SoaBuffer avx2(kFrames);
+        wt9011::decode_frames_avx2(frames.data(), kFrames, avx2.soa());
+        CHECK(avx2.values == scalar.values);
+    } else {
+        std::printf("AVX2 not available, skipped\n");
+    }
+#endif
+
+    // decode_frames_soa stops at the first frame without a data header
+    frames[20 * wt9011::kFrameSize + 1] = wt9011::kFrameTypeRegister;
+    SoaBuffer leading(kFrames);
+    CHECK(wt9011::decode_frames_soa(frames.data(), kFrames, leading.soa()) == 20);
+    for (std::size_t c = 0; c < 9; ++c) {
+        for (std::size_t i = 0; i < kFrames; ++i) {
+            const float expected = i < 20 ? scalar.values[c * kFrames + i] : -1.0f;
+            CHECK(leading.values[c * kFrames + i] == expected);
+        }
+    }
+}
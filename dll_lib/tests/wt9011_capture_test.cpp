@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <vector>
+#include "wt9011_capture.h"
+#include "wt9011_test.h"
+
+namespace {
+
+constexpr char kPath[] = "wt9011_capture_test.bin";
+
+std::vector<std::uint8_t> read_file(const char* path) {
+    std::vector<std::uint8_t> bytes;
+    if (std::FILE* f = std::fopen(path, "rb")) {
+        std::uint8_t buffer[4096];
+        std::size_t n;
+        while ((n = std::fread(buffer, 1, sizeof(buffer), f)) > 0) {
+            bytes.insert(bytes.end(), buffer, buffer + n);
+        }
+        std::fclose(f);
+    }
+    return bytes;
+}
+
+// Records the cursor yields before it stops
+std::size_t count_records(const std::uint8_t* data, std::size_t size) {
+    wt9011::CaptureCursor cursor(data, size);
+    wt9011::CaptureRecord record;
+    std::size_t count = 0;
+    while (cursor.next(record)) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+WT9011_TEST(capture) {
+    // Notifications of 20, 0 and 41 bytes
+    std::vector<std::vector<std::uint8_t>> notifications = { std::vector<std::uint8_t>(20, 0x55), {},
+                                                              std::vector<std::uint8_t>(41) };
+    for (std::size_t i = 0; i < notifications[2].size(); ++i) {
+        notifications[2][i] = static_cast<std::uint8_t>(i);
+    }
+    {
+        wt9011::CaptureWriter writer;
+        CHECK(writer.open(kPath));
+        CHECK(writer.is_open());
+        for (std::size_t i = 0; i < notifications.size(); ++i) {
+            writer.append(100 * (i + 1), notifications[i].data(), notifications[i].size());
+        }
+        CHECK(writer.close());
+    }
+    const std::vector<std::uint8_t> bytes = read_file(kPath);
+    std::remove(kPath);
+
+    wt9011::CaptureCursor cursor(bytes.data(), bytes.size());
+    CHECK(cursor.valid());
+    wt9011::CaptureRecord record;
+    for (std::size_t i = 0; i < notifications.size(); ++i) {
+        CHECK(cursor.next(record));
+        CHECK(record.timestamp_ns == 100 * (i + 1));
+        CHECK(record.length == notifications[i].size());
+        CHECK(record.length == 0 || std::memcmp(record.data, notifications[i].data(), record.length) == 0);
+    }
+    CHECK(!cursor.next(record));
+    cursor.rewind();
+    CHECK(cursor.next(record) && record.timestamp_ns == 100);
+
+    // Cut anywhere: only whole records come out, never bytes past the end
+    const std::size_t ends[] = { wt9011::kCaptureHeaderSize, wt9011::kCaptureHeaderSize + 12 + 20,
+                                 wt9011::kCaptureHeaderSize + 2 * 12 + 20, bytes.size() };
+    for (std::size_t size = wt9011::kCaptureHeaderSize; size <= bytes.size(); ++size) {
+        std::size_t whole = 0;
+        while (whole + 1 < std::size(ends) && ends[whole + 1] <= size) {
+            ++whole;
+        }
+        const std::vector<std::uint8_t> cut(bytes.begin(), bytes.begin() + size);
+        CHECK(count_records(cut.data(), cut.size()) == whole);
+    }
+
+    // A length field larger than the rest of the file
+    std::vector<std::uint8_t> corrupt(bytes.begin(), bytes.begin() + wt9011::kCaptureHeaderSize + 12 + 20);
+    const std::uint32_t huge = 0xFFFFFFFFu;
+    std::memcpy(corrupt.data() + wt9011::kCaptureHeaderSize + 8, &huge, sizeof(huge));
+    CHECK(count_records(corrupt.data(), corrupt.size()) == 0);
+
+    // Foreign or short headers
+    std::vector<std::uint8_t> foreign = bytes;
+    foreign[0] = 'X';
+    CHECK(!wt9011::CaptureCursor(foreign.data(), foreign.size()).valid());
+    CHECK(!wt9011::CaptureCursor(bytes.data(), wt9011::kCaptureHeaderSize - 1).valid());
+    CHECK(!wt9011::CaptureCursor(nullptr, 0).valid());
+}
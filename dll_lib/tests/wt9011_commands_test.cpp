@@ -0,0 +1,34 @@
+#include <cstdint>
+#include <cstring>
+#include "wt9011_commands.h"
+#include "wt9011_test.h"
+
+WT9011_TEST(commands) {
+    const std::uint8_t regs[] = { wt9011::kRegSave, wt9011::kRegReturnRate, wt9011::kRegUnlock, 0xFF };
+    const std::uint16_t values[] = { 0, 1, 0x00FF, 0x0100, wt9011::kUnlockKey, 0xFFFF };
+    for (std::uint8_t reg : regs) {
+        for (std::uint16_t value : values) {
+            const wt9011::Command command = wt9011::encode_command(reg, value);
+            CHECK(command.bytes[0] == 0xFF && command.bytes[1] == 0xAA);
+            CHECK(command.reg() == reg && command.value() == value);
+            std::uint8_t decoded_reg = 0;
+            std::uint16_t decoded_value = 0;
+            CHECK(wt9011::decode_command(command.bytes, wt9011::kCommandSize, decoded_reg, decoded_value));
+            CHECK(decoded_reg == reg && decoded_value == value);
+            // The 4-byte form carries only the low byte
+            CHECK(wt9011::decode_command(command.bytes, wt9011::kCommandSize - 1, decoded_reg, decoded_value));
+            CHECK(decoded_reg == reg && decoded_value == (value & 0xFF));
+        }
+    }
+    const wt9011::Command unlock = wt9011::kCommandUnlock;
+    const std::uint8_t expected[] = { 0xFF, 0xAA, 0x69, 0x88, 0xB5 };
+    CHECK(std::memcmp(unlock.bytes, expected, sizeof(expected)) == 0);
+    CHECK(wt9011::command_read_register(0x34).value() == 0x34);
+
+    std::uint8_t reg = 0;
+    std::uint16_t value = 0;
+    const std::uint8_t bad_header[] = { 0xFF, 0xAB, 0x00, 0x00, 0x00 };
+    CHECK(!wt9011::decode_command(bad_header, sizeof(bad_header), reg, value));
+    CHECK(!wt9011::decode_command(unlock.bytes, 3, reg, value));
+    CHECK(!wt9011::decode_command(nullptr, wt9011::kCommandSize, reg, value));
+}
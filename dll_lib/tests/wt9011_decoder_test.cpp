@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <cstring>
+#include "wt9011_decoder.h"
+#include "wt9011_test.h"
+
+namespace {
+
+// Frame with raw int16 fields in SensorData order
+void make_frame(const std::int16_t (&raw)[9], std::uint8_t* frame) {
+    frame[0] = wt9011::kFrameHeader;
+    frame[1] = wt9011::kFrameTypeData;
+    for (int i = 0; i < 9; ++i) {
+        wt9011::write_i16(frame + 2 + 2 * i, raw[i]);
+    }
+}
+
+} // namespace
+
+WT9011_TEST(decoder) {
+    // Known raw values against the full-scale ranges: 2048 = 1 g,
+    // 16384 = 1000 °/s and 90°
+    std::uint8_t frame[wt9011::kFrameSize];
+    make_frame({ 2048, -2048, 32767, 16384, -16384, 0, 16384, -16384, -32768 }, frame);
+    SensorData data;
+    CHECK(wt9011::decode_frame(frame, sizeof(frame), data));
+    CHECK(data.accel.x == 1.0f && data.accel.y == -1.0f);
+    CHECK_NEAR(data.accel.z, 16.0 * 32767 / 32768, 1e-6);
+    CHECK(data.gyro.x == 1000.0f && data.gyro.y == -1000.0f && data.gyro.z == 0.0f);
+    CHECK(data.angle.roll == 90.0f && data.angle.pitch == -90.0f);
+    CHECK(data.angle.yaw == -180.0f);
+
+    // Same scaling as WT9011Parser.parse, yaw mapped into (-180, 180]
+    CHECK(wt9011::wrap_yaw(270.0f) == -90.0f);
+    CHECK(wt9011::wrap_yaw(180.0f) == 180.0f);
+    CHECK(wt9011::wrap_yaw(-179.5f) == -179.5f);
+    make_frame({ 0, 0, 0, 0, 0, 0, 0, 0, 32767 }, frame);
+    CHECK(wt9011::decode_frame(frame, sizeof(frame), data));
+    CHECK_NEAR(data.angle.yaw, 180.0 * 32767 / 32768, 1e-5);
+
+    // encode_frame is the inverse, saturating outside the range
+    SensorData in;
+    in.accel = { 0.5f, -2.0f, 20.0f };
+    in.gyro = { 123.0f, -456.0f, 1999.0f };
+    in.angle = { 10.0f, -45.0f, 179.0f };
+    wt9011::encode_frame(in, frame);
+    CHECK(wt9011::decode_frame(frame, sizeof(frame), data));
+    CHECK_NEAR(data.accel.x, 0.5, wt9011::kAccelScale);
+    CHECK_NEAR(data.accel.z, 16.0 * 32767 / 32768, 1e-6);
+    CHECK_NEAR(data.gyro.y, -456.0, wt9011::kGyroScale);
+    CHECK_NEAR(data.angle.yaw, 179.0, wt9011::kAngleScale);
+
+    // A 21st byte is the checksum, as in WT9011Parser.parse; longer buffers
+    // carry further frames instead
+    std::uint8_t checked[wt9011::kChecksummedFrameSize];
+    std::memcpy(checked, frame, wt9011::kFrameSize);
+    unsigned sum = 0;
+    for (std::size_t i = 0; i < wt9011::kFrameSize; ++i) {
+        sum += frame[i];
+    }
+    CHECK(wt9011::frame_checksum(frame) == (sum & 0xFF));
+    checked[wt9011::kFrameSize] = wt9011::frame_checksum(frame);
+    CHECK(wt9011::decode_frame(checked, sizeof(checked), data));
+    CHECK_NEAR(data.gyro.y, -456.0, wt9011::kGyroScale);
+    checked[wt9011::kFrameSize] ^= 0x01;
+    SensorData untouched = wt9011_test::uniform(7.0f);
+    CHECK(!wt9011::decode_frame(checked, sizeof(checked), untouched));
+
+    // Short frames and foreign headers leave `out` untouched
+    CHECK(!wt9011::decode_frame(frame, wt9011::kFrameSize - 1, untouched));
+    frame[1] = wt9011::kFrameTypeRegister;
+    CHECK(!wt9011::decode_frame(frame, sizeof(frame), untouched));
+    frame[0] = 0x54;
+    frame[1] = wt9011::kFrameTypeData;
+    CHECK(!wt9011::decode_frame(frame, sizeof(frame), untouched));
+    CHECK(untouched.accel.x == 7.0f && untouched.angle.yaw == 7.0f);
+}
@@ -0,0 +1,66 @@
+#include <memory>
+#include <vector>
+#include "wt9011_filters.h"
+#include "wt9011_test.h"
+
+namespace {
+
+// Output of a one-stage chain for a constant input, after the transient
+float settled(const FilterStageConfig& stage, float input) {
+    std::unique_ptr<wt9011::FilterChain> chain = wt9011::FilterChain::create(&stage, 1, 100.0f);
+    SensorData data = wt9011_test::uniform(input);
+    for (int i = 0; i < 2000; ++i) {
+        data = wt9011_test::uniform(input);
+        chain->process(data);
+    }
+    return data.accel.x;
+}
+
+} // namespace
+
+WT9011_TEST(filters) {
+    // DC gain of the biquads
+    CHECK_NEAR(settled({ WT9011_FILTER_LOWPASS, 5.0f, 0.0f, 0, 0 }, 1.5f), 1.5, 1e-4);
+    CHECK_NEAR(settled({ WT9011_FILTER_HIGHPASS, 5.0f, 0.0f, 0, 0 }, 1.5f), 0.0, 1e-4);
+    CHECK_NEAR(settled({ WT9011_FILTER_BANDPASS, 10.0f, 2.0f, 0, 0 }, 1.5f), 0.0, 1e-4);
+    CHECK_NEAR(settled({ WT9011_FILTER_NOTCH, 10.0f, 2.0f, 0, 0 }, 1.5f), 1.5, 1e-4);
+
+    // Median of 3 removes single spikes; gyro is left out of the stage
+    const FilterStageConfig median = { WT9011_FILTER_MEDIAN, 0.0f, 0.0f, 3, WT9011_CHANNEL_ACCEL };
+    std::unique_ptr<wt9011::FilterChain> chain = wt9011::FilterChain::create(&median, 1, 100.0f);
+    CHECK(chain != nullptr);
+    const float input[] = { 1.0f, 100.0f, 2.0f, 3.0f, -50.0f, 4.0f };
+    const float expected[] = { 2.0f, 3.0f, 2.0f, 3.0f };
+    for (std::size_t i = 0; i < 6; ++i) {
+        SensorData data = wt9011_test::uniform(input[i]);
+        CHECK(chain->process(data));
+        if (i >= 2) {
+            CHECK(data.accel.x == expected[i - 2] && data.accel.z == expected[i - 2]);
+        }
+        CHECK(data.gyro.x == input[i]);
+    }
+
+    // Decimation keeps the first of every `length` samples, unchanged
+    const FilterStageConfig decimate = { WT9011_FILTER_DECIMATE, 0.0f, 0.0f, 4, 0 };
+    chain = wt9011::FilterChain::create(&decimate, 1, 100.0f);
+    std::vector<float> kept;
+    for (int i = 0; i < 10; ++i) {
+        SensorData data = wt9011_test::uniform(static_cast<float>(i));
+        if (chain->process(data)) {
+            kept.push_back(data.angle.yaw);
+        }
+    }
+    CHECK((kept == std::vector<float>{ 0.0f, 4.0f, 8.0f }));
+
+    // Invalid stages
+    const FilterStageConfig invalid[] = {
+        { WT9011_FILTER_LOWPASS, 50.0f, 0.0f, 0, 0 },  // At Nyquist
+        { WT9011_FILTER_MEDIAN, 0.0f, 0.0f, 0, 0 },
+        { WT9011_FILTER_MEDIAN, 0.0f, 0.0f, wt9011::kMaxMedianWindow + 1, 0 },
+        { WT9011_FILTER_DECIMATE, 0.0f, 0.0f, 2, 0x200 },
+        { 42, 0.0f, 0.0f, 1, 0 },
+    };
+    for (const FilterStageConfig& stage : invalid) {
+        CHECK(wt9011::FilterChain::create(&stage, 1, 100.0f) == nullptr);
+    }
+}
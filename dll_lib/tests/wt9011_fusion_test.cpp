@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "wt9011_fusion.h"
+#include "wt9011_test.h"
+
+namespace {
+
+constexpr std::size_t kLanes = 7; // Four SSE2 lanes and a scalar tail
+constexpr float kRateHz = 100.0f;
+
+// Lane `lane` at step `step`: its own tilt, turn rate and some noise
+SensorSample lane_sample(std::size_t lane, int step) {
+    const double roll = (10.0 + 7.0 * lane) * wt9011_test::kPi / 180.0;
+    const double noise = 0.01 * std::sin(0.7 * step + lane);
+    SensorData data;
+    data.accel = { static_cast<float>(noise), static_cast<float>(std::sin(roll)),
+                   static_cast<float>(std::cos(roll) - noise) };
+    data.gyro = { static_cast<float>(5.0 * lane - 10.0), static_cast<float>(20.0 * noise),
+                  static_cast<float>(30.0 + 15.0 * lane) };
+    data.angle = { 0.0f, 0.0f, 0.0f };
+    return wt9011_test::sample_at(static_cast<std::uint64_t>(step) * 10000000ull, data);
+}
+
+float yaw_degrees(const float* q) {
+    return static_cast<float>(std::atan2(2.0 * (q[0] * q[3] + q[1] * q[2]), 1.0 - 2.0 * (q[2] * q[2] + q[3] * q[3])) *
+                              180.0 / wt9011_test::kPi);
+}
+
+void check_lanes_match_scalar(int algorithm) {
+    const FusionConfig config = { algorithm, 0.0f, 0.05f, kRateHz };
+    wt9011::FusionBank bank(config, kLanes);
+    std::vector<std::unique_ptr<wt9011::FusionBank>> single;
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        single.push_back(std::make_unique<wt9011::FusionBank>(config, 1));
+    }
+    SensorSample samples[kLanes];
+    FusedSample fused[kLanes];
+    double worst = 0.0;
+    for (int step = 0; step < 500; ++step) {
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            samples[lane] = lane_sample(lane, step);
+        }
+        bank.update(0, samples, kLanes, fused);
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            FusedSample one;
+            single[lane]->update(0, &samples[lane], 1, &one);
+            for (int k = 0; k < 4; ++k) {
+                worst = std::max(worst, std::fabs(static_cast<double>(fused[lane].quaternion[k] - one.quaternion[k])));
+            }
+        }
+    }
+    CHECK(worst < 1e-5);
+}
+
+// Level sensor turning at 90 °/s about z: one second later yaw is 90°, and
+// the accelerometer then sees only gravity
+void check_steady_rotation(int algorithm) {
+    const FusionConfig config = { algorithm, 0.0f, 0.0f, kRateHz };
+    wt9011::FusionBank bank(config, 1);
+    SensorData data = wt9011_test::uniform(0.0f);
+    data.accel.z = 1.0f;
+    data.gyro.z = 90.0f;
+    FusedSample fused;
+    for (int step = 0; step <= static_cast<int>(kRateHz); ++step) {
+        const SensorSample sample = wt9011_test::sample_at(static_cast<std::uint64_t>(step) * 10000000ull, data);
+        bank.update(0, &sample, 1, &fused);
+    }
+    CHECK_NEAR(yaw_degrees(fused.quaternion), 90.0, 0.1);
+    const float* q = fused.quaternion;
+    CHECK_NEAR(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3], 1.0, 1e-5);
+    CHECK_NEAR(q[1], 0.0, 1e-4);
+    CHECK_NEAR(q[2], 0.0, 1e-4);
+    CHECK_NEAR(fused.linear_accel[0], 0.0, 1e-4);
+    CHECK_NEAR(fused.linear_accel[2], 0.0, 1e-4);
+}
+
+} // namespace
+
+WT9011_TEST(fusion) {
+    check_lanes_match_scalar(WT9011_FUSION_MADGWICK);
+    check_lanes_match_scalar(WT9011_FUSION_MAHONY);
+    check_steady_rotation(WT9011_FUSION_MADGWICK);
+    check_steady_rotation(WT9011_FUSION_MAHONY);
+
+    // The first sample sets the tilt from gravity: 30° of roll
+    wt9011::FusionBank bank({ WT9011_FUSION_MADGWICK, 0.0f, 0.0f, 0.0f }, 1);
+    SensorData data = wt9011_test::uniform(0.0f);
+    data.accel.y = 0.5f;
+    data.accel.z = static_cast<float>(std::sqrt(0.75));
+    const SensorSample sample = wt9011_test::sample_at(0, data);
+    FusedSample fused;
+    bank.update(0, &sample, 1, &fused);
+    CHECK_NEAR(fused.quaternion[0], std::cos(wt9011_test::kPi / 12), 1e-6);
+    CHECK_NEAR(fused.quaternion[1], std::sin(wt9011_test::kPi / 12), 1e-6);
+    CHECK_NEAR(fused.linear_accel[1], 0.0, 1e-6);
+
+    // Lanes past the end are ignored
+    fused.quaternion[0] = 42.0f;
+    bank.update(1, &sample, 1, &fused);
+    CHECK(fused.quaternion[0] == 42.0f);
+}
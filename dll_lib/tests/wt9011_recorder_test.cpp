@@ -0,0 +1,108 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "wt9011_recorder.h"
+#include "wt9011_test.h"
+
+namespace {
+
+constexpr char kPath[] = "wt9011_recorder_test.bin";
+constexpr char kUnfinishedPath[] = "wt9011_recorder_test_unfinished.bin";
+
+std::vector<char> read_file(const char* path) {
+    std::vector<char> bytes;
+    if (std::FILE* f = std::fopen(path, "rb")) {
+        char buffer[65536];
+        std::size_t n;
+        while ((n = std::fread(buffer, 1, sizeof(buffer), f)) > 0) {
+            bytes.insert(bytes.end(), buffer, buffer + n);
+        }
+        std::fclose(f);
+    }
+    return bytes;
+}
+
+bool write_file(const char* path, const char* data, std::size_t size) {
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+    const bool ok = std::fwrite(data, 1, size, f) == size;
+    return std::fclose(f) == 0 && ok;
+}
+
+// Every column of chunk `index` against what sample_for(i) wrote
+bool chunk_matches(const wt9011::RecordingReader& reader, std::size_t index, std::size_t count) {
+    RecordingChunk chunk;
+    if (!reader.chunk(index, chunk) || chunk.count != count) {
+        return false;
+    }
+    for (std::size_t j = 0; j < count; ++j) {
+        const std::uint64_t i = index * wt9011::kSamplesPerChunk + j;
+        if (chunk.timestamp_ns[j] != 1000 + 5 * i || chunk.sequence[j] != i || chunk.sensor_id[j] != i % 2 ||
+            chunk.ax[j] != static_cast<float>(i) || chunk.yaw[j] != -static_cast<float>(i) ||
+            chunk.gy[j] != 0.5f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+WT9011_TEST(recorder) {
+    // Two sensors, one full chunk and a partial one
+    const std::size_t total = wt9011::kSamplesPerChunk + 100;
+    {
+        wt9011::Recorder recorder;
+        CHECK(recorder.open(kPath));
+        CHECK(!recorder.open(kPath));
+        const std::uint32_t ids[] = { recorder.add_sensor("AA:BB:CC:DD:EE:01"), recorder.add_sensor("sim-2") };
+        CHECK(ids[0] == 0 && ids[1] == 1);
+        CHECK(recorder.add_sensor("AA:BB:CC:DD:EE:01") == 0);
+        for (std::size_t i = 0; i < total; ++i) {
+            SensorData data = wt9011_test::uniform(0.5f);
+            data.accel.x = static_cast<float>(i);
+            data.angle.yaw = -static_cast<float>(i);
+            SensorSample sample = wt9011_test::sample_at(1000 + 5 * i, data);
+            sample.sequence = i;
+            recorder.append(ids[i % 2], sample);
+        }
+        CHECK(recorder.close());
+        CHECK(recorder.samples() == total && recorder.dropped() == 0);
+    }
+
+    wt9011::RecordingReader reader;
+    CHECK(reader.open(kPath));
+    CHECK(reader.chunk_count() == 2);
+    CHECK(reader.sensor_count() == 2);
+    CHECK(reader.sensor_address(0) && std::string(reader.sensor_address(0)) == "AA:BB:CC:DD:EE:01");
+    CHECK(reader.sensor_address(1) && std::string(reader.sensor_address(1)) == "sim-2");
+    CHECK(reader.sensor_address(2) == nullptr);
+    CHECK(chunk_matches(reader, 0, wt9011::kSamplesPerChunk));
+    CHECK(chunk_matches(reader, 1, 100));
+    RecordingChunk chunk;
+    CHECK(!reader.chunk(2, chunk));
+    reader.close();
+
+    // A writer that died in the middle of its second chunk: the whole chunk
+    // is still readable, without a sensor table
+    const std::vector<char> bytes = read_file(kPath);
+    const std::size_t cut = sizeof(wt9011::RecordingHeader) + wt9011::kChunkSize + wt9011::kChunkSize / 2;
+    CHECK(bytes.size() > cut);
+    CHECK(write_file(kUnfinishedPath, bytes.data(), cut));
+    CHECK(reader.open(kUnfinishedPath));
+    CHECK(reader.chunk_count() == 1);
+    CHECK(reader.sensor_count() == 0 && reader.sensor_address(0) == nullptr);
+    CHECK(chunk_matches(reader, 0, wt9011::kSamplesPerChunk));
+    reader.close();
+
+    // Not even a whole header
+    CHECK(write_file(kUnfinishedPath, bytes.data(), sizeof(wt9011::RecordingHeader) - 1));
+    CHECK(!reader.open(kUnfinishedPath));
+
+    std::remove(kPath);
+    std::remove(kUnfinishedPath);
+}
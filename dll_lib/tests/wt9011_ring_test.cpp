@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "wt9011_ring.h"
+#include "wt9011_test.h"
+
+WT9011_TEST(ring) {
+    // Overflow leaves the ring untouched
+    wt9011::SpscRing<int, 8> ring;
+    for (int i = 0; i < 8; ++i) {
+        CHECK(ring.try_push(i));
+    }
+    CHECK(!ring.try_push(8));
+    CHECK(ring.size() == 8);
+
+    // Indices wrap many times over; items come out oldest first
+    int out[8];
+    int next_in = 8, next_out = 0;
+    for (int round = 0; round < 100; ++round) {
+        const std::size_t take = 1 + round % 5;
+        const std::size_t n = ring.pop(out, take);
+        CHECK(n == take);
+        for (std::size_t i = 0; i < n; ++i) {
+            CHECK(out[i] == next_out++);
+        }
+        while (ring.try_push(next_in)) {
+            ++next_in;
+        }
+        CHECK(ring.size() == ring.capacity());
+    }
+
+    // consume() visits in order and releases only what it visited
+    std::vector<int> seen;
+    CHECK(ring.consume(3, [&seen](std::size_t i, const int& item) {
+        CHECK(i == seen.size());
+        seen.push_back(item);
+    }) == 3);
+    CHECK((seen == std::vector<int>{ next_out, next_out + 1, next_out + 2 }));
+    next_out += 3;
+    CHECK(ring.size() == 5);
+    CHECK(ring.pop(out, 100) == 5 && out[0] == next_out && out[4] == next_out + 4);
+    CHECK(ring.pop(out, 100) == 0);
+
+    // One producer and one consumer thread: nothing lost, nothing reordered
+    constexpr std::uint64_t kItems = 1000000;
+    static wt9011::SpscRing<std::uint64_t, 1024> shared;
+    std::thread producer([] {
+        for (std::uint64_t i = 0; i < kItems; ++i) {
+            while (!shared.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::uint64_t expected = 0;
+    bool ordered = true;
+    std::uint64_t batch[64];
+    while (expected < kItems) {
+        const std::size_t n = shared.pop(batch, 64);
+        for (std::size_t i = 0; i < n; ++i) {
+            ordered = ordered && batch[i] == expected++;
+        }
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK(shared.size() == 0);
+}
@@ -0,0 +1,75 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include "wt9011_spectrum.h"
+#include "wt9011_test.h"
+
+WT9011_TEST(spectrum) {
+    // Against a direct DFT
+    constexpr std::size_t kN = 64;
+    wt9011::FftPlan plan(kN);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> uniform_value(-1.0f, 1.0f);
+    std::vector<float> in(kN), re(kN / 2 + 1), im(kN / 2 + 1), work_re(kN / 2), work_im(kN / 2);
+    for (float& x : in) {
+        x = uniform_value(rng);
+    }
+    plan.forward(in.data(), re.data(), im.data(), work_re.data(), work_im.data());
+    for (std::size_t k = 0; k <= kN / 2; ++k) {
+        double dft_re = 0.0, dft_im = 0.0;
+        for (std::size_t i = 0; i < kN; ++i) {
+            dft_re += in[i] * std::cos(2.0 * wt9011_test::kPi * k * i / kN);
+            dft_im -= in[i] * std::sin(2.0 * wt9011_test::kPi * k * i / kN);
+        }
+        CHECK_NEAR(re[k], dft_re, 1e-4);
+        CHECK_NEAR(im[k], dft_im, 1e-4);
+    }
+
+    // Sines between bins on an offset: peak frequency, amplitude within the 3%
+    // the parabolic refinement leaves under Hann, and band energy A^2 / 2 in
+    // the band that holds the tone
+    SpectrumConfig config = {};
+    config.fft_size = 256;
+    config.window = WT9011_WINDOW_HANN;
+    config.channels = WT9011_CHANNEL_ACCEL;
+    config.sample_rate_hz = 100.0f;
+    config.band_count = 3;
+    const float edges[] = { 0.0f, 5.0f, 20.0f, 50.0f };
+    std::memcpy(config.band_edges_hz, edges, sizeof(edges));
+    std::unique_ptr<wt9011::SpectrumAnalyzer> analyzer = wt9011::SpectrumAnalyzer::create(config);
+    CHECK(analyzer != nullptr);
+
+    SpectrumReport report;
+    CHECK(!analyzer->latest(report));
+    int analyses = 0;
+    for (std::size_t i = 0; i < config.fft_size; ++i) {
+        const double t = i / static_cast<double>(config.sample_rate_hz);
+        SensorData data = wt9011_test::uniform(0.0f);
+        data.accel.x = static_cast<float>(0.5 + 2.0 * std::sin(2.0 * wt9011_test::kPi * 10.3 * t));
+        data.accel.z = static_cast<float>(std::sin(2.0 * wt9011_test::kPi * 31.7 * t + 1.0));
+        analyses += analyzer->add(wt9011_test::sample_at(i * 10000000ull, data));
+    }
+    CHECK(analyses == 1);
+    CHECK(analyzer->latest(report));
+    CHECK(report.channels == WT9011_CHANNEL_ACCEL);
+
+    const ChannelSpectrum& x = report.channel[0];
+    CHECK_NEAR(x.peaks[0].frequency_hz, 10.3, 0.05);
+    CHECK_NEAR(x.peaks[0].amplitude, 2.0, 0.06);
+    CHECK_NEAR(x.band_energy[1], 2.0, 0.05);
+    CHECK(x.band_energy[0] < 0.01 && x.band_energy[2] < 0.01);
+
+    const ChannelSpectrum& z = report.channel[2];
+    CHECK_NEAR(z.peaks[0].frequency_hz, 31.7, 0.05);
+    CHECK_NEAR(z.peaks[0].amplitude, 1.0, 0.03);
+    CHECK_NEAR(z.band_energy[2], 0.5, 0.0125);
+
+    CHECK(report.channel[1].band_energy[1] == 0.0f && report.channel[1].peaks[0].amplitude == 0.0f);
+    CHECK(report.channel[3].band_energy[1] == 0.0f);
+
+    config.fft_size = 100;
+    CHECK(wt9011::SpectrumAnalyzer::create(config) == nullptr);
+}
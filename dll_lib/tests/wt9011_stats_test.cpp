@@ -0,0 +1,71 @@
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "wt9011_stats.h"
+#include "wt9011_test.h"
+
+using wt9011::LatencyHistogram;
+
+WT9011_TEST(stats) {
+    // Exact below 16; above, buckets are contiguous, increasing and at most
+    // 6.25% wide
+    for (std::uint64_t v = 0; v < LatencyHistogram::kSubBuckets; ++v) {
+        CHECK(LatencyHistogram::bucket_of(v) == v && LatencyHistogram::bucket_upper(v) == v);
+    }
+    for (std::size_t b = 0; b + 1 < LatencyHistogram::kBuckets; ++b) {
+        const std::uint64_t upper = LatencyHistogram::bucket_upper(b);
+        CHECK(LatencyHistogram::bucket_of(upper) == b);
+        CHECK(LatencyHistogram::bucket_of(upper + 1) == b + 1);
+    }
+    CHECK(LatencyHistogram::bucket_upper(LatencyHistogram::kBuckets - 1) ==
+          std::numeric_limits<std::uint64_t>::max());
+    std::vector<std::uint64_t> values = { 16, 17, 31, 32, 33, 1000, 65535, 65536, 999999937ull, 1ull << 40 };
+    for (unsigned shift = 4; shift < 64; ++shift) {
+        values.push_back((1ull << shift) - 1);
+        values.push_back((1ull << shift) + 1);
+    }
+    for (std::uint64_t v : values) {
+        const std::size_t bucket = LatencyHistogram::bucket_of(v);
+        CHECK(bucket < LatencyHistogram::kBuckets);
+        const std::uint64_t upper = LatencyHistogram::bucket_upper(bucket);
+        CHECK(upper >= v && upper - v <= v / LatencyHistogram::kSubBuckets);
+    }
+
+    // Percentiles are the upper edge of the bucket that reaches the rank,
+    // never above the largest recorded value
+    LatencyHistogram histogram;
+    LatencyStats stats;
+    histogram.snapshot(stats);
+    CHECK(stats.count == 0 && stats.mean_ns == 0.0 && stats.p50_ns == 0 && stats.p999_ns == 0 && stats.max_ns == 0);
+
+    for (std::uint64_t v = 1; v <= 1000; ++v) {
+        histogram.record(v);
+    }
+    histogram.snapshot(stats);
+    CHECK(stats.count == 1000);
+    CHECK(stats.mean_ns == 500.5);
+    CHECK(stats.max_ns == 1000);
+    CHECK(stats.p50_ns == LatencyHistogram::bucket_upper(LatencyHistogram::bucket_of(500)));
+    CHECK(stats.p90_ns == LatencyHistogram::bucket_upper(LatencyHistogram::bucket_of(900)));
+    CHECK(stats.p99_ns == LatencyHistogram::bucket_upper(LatencyHistogram::bucket_of(990)));
+    CHECK(stats.p999_ns == 1000);
+    CHECK(stats.p50_ns >= 500 && stats.p50_ns <= 500 * 17 / 16);
+    CHECK(stats.p99_ns >= 990 && stats.p99_ns <= 990 * 17 / 16);
+
+    // One outlier in a thousand shows only in max
+    histogram.reset();
+    for (int i = 0; i < 999; ++i) {
+        histogram.record(100);
+    }
+    histogram.record(5000000);
+    histogram.snapshot(stats);
+    CHECK(stats.p50_ns == LatencyHistogram::bucket_upper(LatencyHistogram::bucket_of(100)));
+    CHECK(stats.p99_ns == stats.p50_ns);
+    CHECK(stats.p999_ns == stats.p50_ns);
+    CHECK(stats.max_ns == 5000000);
+
+    histogram.reset();
+    histogram.record(12345);
+    histogram.snapshot(stats);
+    CHECK(stats.count == 1 && stats.p50_ns == 12345 && stats.p999_ns == 12345 && stats.max_ns == 12345);
+}
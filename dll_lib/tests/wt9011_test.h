@@ -0,0 +1,50 @@
+#ifndef WT9011_TEST_H
+#define WT9011_TEST_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include "wt9011_types.h"
+
+// Check macros and case registry of wt9011_tests. A case is defined with
+// WT9011_TEST(name) in wt9011_<name>_test.cpp and runs as the CTest test
+// `name`; failed checks are reported and counted, the case goes on.
+namespace wt9011_test {
+
+constexpr double kPi = 3.14159265358979323846;
+
+extern int failures;
+
+struct Registrar {
+    Registrar(const char* name, void (*run)());
+};
+
+// Every channel set to `value`
+SensorData uniform(float value);
+SensorSample sample_at(std::uint64_t timestamp_ns, const SensorData& data);
+
+} // namespace wt9011_test
+
+#define WT9011_TEST(name)                                                                      \
+    static void wt9011_test_##name();                                                          \
+    static const wt9011_test::Registrar wt9011_registrar_##name(#name, &wt9011_test_##name); \
+    static void wt9011_test_##name()
+
+#define CHECK(cond)                                                                        \
+    do {                                                                                   \
+        if (!(cond)) {                                                                     \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++wt9011_test::failures;                                                       \
+        }                                                                                  \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                        \
+    do {                                                                                               \
+        const double a_ = (actual), e_ = (expected);                                                   \
+        if (!(std::fabs(a_ - e_) <= (tolerance))) {                                                    \
+            std::fprintf(stderr, "%s:%d: %s = %g, expected %g\n", __FILE__, __LINE__, #actual, a_, e_); \
+            ++wt9011_test::failures;                                                                   \
+        }                                                                                              \
+    } while (0)
+
+#endif // WT9011_TEST_H
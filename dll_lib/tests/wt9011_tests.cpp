@@ -0,0 +1,66 @@
+// Tests of the stages that need neither Python nor a sensor. Each case is a
+// CTest test of its own; without arguments all of them run:
+//
+//   wt9011_tests [case]
+#include <cstring>
+#include <vector>
+#include "wt9011_test.h"
+
+namespace wt9011_test {
+
+int failures = 0;
+
+namespace {
+
+struct Case {
+    const char* name;
+    void (*run)();
+};
+
+std::vector<Case>& cases() {
+    static std::vector<Case> instance;
+    return instance;
+}
+
+} // namespace
+
+Registrar::Registrar(const char* name, void (*run)()) {
+    cases().push_back({ name, run });
+}
+
+SensorData uniform(float value) {
+    SensorData data;
+    data.accel = { value, value, value };
+    data.gyro = { value, value, value };
+    data.angle = { value, value, value };
+    return data;
+}
+
+SensorSample sample_at(std::uint64_t timestamp_ns, const SensorData& data) {
+    SensorSample sample;
+    sample.data = data;
+    sample.timestamp_ns = timestamp_ns;
+    sample.sequence = 0;
+    return sample;
+}
+
+} // namespace wt9011_test
+
+int main(int argc, char** argv) {
+    bool found = argc < 2;
+    for (const wt9011_test::Case& c : wt9011_test::cases()) {
+        if (argc < 2 || std::strcmp(argv[1], c.name) == 0) {
+            c.run();
+            found = true;
+        }
+    }
+    if (!found) {
+        std::fprintf(stderr, "unknown test: %s\n", argv[1]);
+        return 2;
+    }
+    if (wt9011_test::failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", wt9011_test::failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include <cmath>
+#include <cstdint>
+#include "wt9011_window_stats.h"
+#include "wt9011_test.h"
+
+WT9011_TEST(window) {
+    constexpr std::uint64_t kMs = 1000000;
+
+    // 1 s window, a sample every 100 ms: at 1.5 s the samples from 0.6 s on remain
+    wt9011::SlidingWindow window(1000 * kMs, 64);
+    for (int i = 0; i <= 15; ++i) {
+        SensorData data = wt9011_test::uniform(0.0f);
+        data.accel.x = static_cast<float>(i);
+        data.accel.y = static_cast<float>(-i);
+        window.add(wt9011_test::sample_at(i * 100 * kMs, data));
+    }
+    WindowStats stats;
+    window.query(stats);
+    CHECK(stats.count == 10);
+    CHECK(stats.first_timestamp_ns == 600 * kMs && stats.last_timestamp_ns == 1500 * kMs);
+    CHECK_NEAR(stats.channels[0].mean, 10.5, 1e-9);
+    CHECK_NEAR(stats.channels[0].variance, 8.25, 1e-9);
+    CHECK_NEAR(stats.channels[0].rms, std::sqrt(8.25 + 10.5 * 10.5), 1e-9);
+    CHECK(stats.channels[0].min == 6.0 && stats.channels[0].max == 15.0);
+    CHECK(stats.channels[1].min == -15.0 && stats.channels[1].max == -6.0);
+    CHECK(stats.channels[2].variance == 0.0);
+
+    // Capacity 5 rounds up to 8; older samples leave early
+    wt9011::SlidingWindow full(1000000 * kMs, 5);
+    for (int i = 0; i < 20; ++i) {
+        SensorData data = wt9011_test::uniform(static_cast<float>(i % 2 ? i : -i));
+        full.add(wt9011_test::sample_at(i * kMs, data));
+    }
+    full.query(stats);
+    CHECK(stats.count == 8);
+    CHECK(stats.first_timestamp_ns == 12 * kMs);
+    CHECK(stats.channels[0].min == -18.0 && stats.channels[0].max == 19.0);
+    CHECK_NEAR(stats.channels[0].mean, (-12 + 13 - 14 + 15 - 16 + 17 - 18 + 19) / 8.0, 1e-9);
+
+    full.clear();
+    full.query(stats);
+    CHECK(stats.count == 0);
+}
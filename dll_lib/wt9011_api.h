@@ -0,0 +1,189 @@
+#ifndef WT9011_API_H
+#define WT9011_API_H
+
+#include <stddef.h>
+#include "wt9011_types.h"
+
+// Export macro for the functions shared between the DLL and the Qt app.
+// The DLL target defines WT9011_DLL_EXPORTS; the app links the sources directly.
+#if defined(_WIN32) && defined(WT9011_DLL_EXPORTS)
+#define WT9011_API extern "C" __declspec(dllexport)
+#else
+#define WT9011_API extern "C"
+#endif
+
+// Completion handle of an operation running on the library's I/O loop
+typedef struct wt9011_op wt9011_op;
+
+// Wait for an operation. timeout_ms < 0 waits forever.
+// Returns 1 on success, 0 if still running after the timeout, -1 if it failed.
+WT9011_API int wt9011_op_wait(wt9011_op* op, int timeout_ms);
+// Non-blocking check whether the operation has finished (successfully or not)
+WT9011_API bool wt9011_op_done(wt9011_op* op);
+// Register values of a completed read (wt9011_session_read_register_async):
+// up to `max` of the 8 registers starting at the one requested
+WT9011_API bool wt9011_op_registers(wt9011_op* op, unsigned short* values, size_t max);
+// Release the handle; the operation itself keeps running if not finished
+WT9011_API void wt9011_op_free(wt9011_op* op);
+
+// Connection to one sensor. Any number of sessions can be open at once; they
+// share the library's I/O loop but have their own connection, frame
+// assembler, sample queue and callback.
+typedef struct wt9011_session wt9011_session;
+
+// Per-session sample callback; `user` is the pointer given to wt9011_session_receive
+typedef void (*SessionSampleCallback)(wt9011_session* session, const SensorSample* sample, void* user);
+
+// Fused sample callback (wt9011_session_set_fusion)
+typedef void (*SessionFusedCallback)(wt9011_session* session, const FusedSample* sample, void* user);
+
+// Spectrum report callback (wt9011_session_set_spectrum)
+typedef void (*SessionSpectrumCallback)(wt9011_session* session, const SpectrumReport* report, void* user);
+
+// Current time on the monotonic clock used for SensorSample::timestamp_ns
+WT9011_API unsigned long long wt9011_monotonic_ns();
+
+// Create a session for `address` without connecting
+WT9011_API wt9011_session* wt9011_session_create(const char* address);
+// Start connecting a created session
+WT9011_API wt9011_op* wt9011_session_connect_async(wt9011_session* session);
+// Create a session and connect it; returns nullptr on failure
+WT9011_API wt9011_session* wt9011_open(const char* address);
+// Disconnect and free the session; the handle is invalid afterwards
+WT9011_API bool wt9011_close(wt9011_session* session);
+// Start disconnecting and free the session without waiting for the link to
+// close; the handle is invalid afterwards, the returned operation is not
+WT9011_API wt9011_op* wt9011_session_disconnect_async(wt9011_session* session);
+
+// Start notifications. With a null callback samples are queued for wt9011_session_poll.
+WT9011_API bool wt9011_session_receive(wt9011_session* session, SessionSampleCallback callback, void* user);
+// Drain up to `max` queued samples; one polling thread per session
+WT9011_API size_t wt9011_session_poll(wt9011_session* session, SensorData* out, size_t max);
+WT9011_API size_t wt9011_session_poll_samples(wt9011_session* session, SensorSample* out, size_t max);
+WT9011_API bool wt9011_session_send(wt9011_session* session, const unsigned char* command, int length);
+WT9011_API wt9011_op* wt9011_session_send_async(wt9011_session* session, const unsigned char* command, int length);
+// Write any register of the WitMotion map (FF AA reg lo hi, see wt9011_commands.h)
+WT9011_API bool wt9011_session_write_register(wt9011_session* session, unsigned char reg, unsigned short value);
+WT9011_API wt9011_op* wt9011_session_write_register_async(wt9011_session* session, unsigned char reg,
+                                                          unsigned short value);
+// Read registers back (FF AA 27 reg 00, answered by a 0x55 0x71 frame). Replies
+// arrive in the receive stream, so the session must be receiving. The op fails
+// after `timeout_ms` (< 0: 1000 ms); read values with wt9011_op_registers.
+WT9011_API wt9011_op* wt9011_session_read_register_async(wt9011_session* session, unsigned char reg, int timeout_ms);
+WT9011_API bool wt9011_session_read_register(wt9011_session* session, unsigned char reg, unsigned short* value,
+                                             int timeout_ms);
+// Read `reg_count` registers of `count` sessions, all requests in flight at
+// once. out[i * reg_count + j] is register regs[j] of sessions[i]; ok (may be
+// null) flags which reads succeeded. Returns the number of successful reads.
+WT9011_API size_t wt9011_read_config(wt9011_session* const* sessions, size_t count, const unsigned char* regs,
+                                     size_t reg_count, unsigned short* out, bool* ok, int timeout_ms);
+
+// Filter the decoded channels in the library, once for every consumer: biquads
+// (low/high/band-pass, notch), moving average, median and decimation, applied
+// in order before recording, fusion, callback and poll queue. Biquads are
+// designed for `sample_rate_hz`. Null or zero stages remove the chain; a new
+// chain starts with empty state. False if any stage is invalid.
+WT9011_API bool wt9011_session_set_filters(wt9011_session* session, const FilterStageConfig* stages, size_t count,
+                                           float sample_rate_hz);
+
+// Keep mean, variance, RMS, min and max of every channel over the last
+// seconds[0 .. count - 1], updated in O(1) per sample. Memory is sized for
+// `max_rate_hz` (<= 0: 200 Hz); faster streams shorten the windows. Null or
+// zero windows stop tracking.
+WT9011_API bool wt9011_session_set_windows(wt9011_session* session, const double* seconds, size_t count,
+                                           double max_rate_hz);
+// Statistics of window `window` (index into seconds); any thread
+WT9011_API bool wt9011_session_window_stats(wt9011_session* session, size_t window, WindowStats* out);
+
+// Windowed FFT of the last fft_size samples every `hop` samples (0: half a
+// window), reduced to band energies and the strongest peaks per channel.
+// Plans and buffers are allocated here, never per analysis. `callback`, if
+// any, gets each report on the delivering thread. A null config turns the
+// analysis off; false on an invalid config.
+WT9011_API bool wt9011_session_set_spectrum(wt9011_session* session, const SpectrumConfig* config,
+                                            SessionSpectrumCallback callback, void* user);
+// Latest report; any thread. False before the first analysis.
+WT9011_API bool wt9011_session_spectrum(wt9011_session* session, SpectrumReport* out);
+// Amplitude spectrum of channel 0 .. 8 (accel x .. yaw) from the latest
+// report, bin k at k * sample_rate_hz / fft_size; returns the bins copied
+WT9011_API size_t wt9011_session_spectrum_bins(wt9011_session* session, unsigned channel, float* out, size_t max);
+
+// Run an AHRS filter (Madgwick or Mahony) on the session's decoded samples and
+// pass quaternion and gravity-free acceleration to `callback`, on the delivering
+// thread before the sample callback. A null config turns fusion off. The
+// previous callback may still see one sample after the call returns.
+WT9011_API bool wt9011_session_set_fusion(wt9011_session* session, const FusionConfig* config,
+                                          SessionFusedCallback callback, void* user);
+
+// The same filters for samples gathered by the caller, e.g. polled from many
+// sessions: lane i of the bank is advanced with samples[i], four lanes per
+// SIMD instruction. Returns the number of lanes updated.
+typedef struct wt9011_fusion wt9011_fusion;
+
+WT9011_API wt9011_fusion* wt9011_fusion_create(const FusionConfig* config, size_t lanes);
+WT9011_API size_t wt9011_fusion_update(wt9011_fusion* fusion, const SensorSample* samples, size_t count,
+                                       FusedSample* out);
+// Forget all orientations; each lane restarts from its next sample's gravity
+WT9011_API void wt9011_fusion_reset(wt9011_fusion* fusion);
+WT9011_API void wt9011_fusion_free(wt9011_fusion* fusion);
+
+// Write every raw notification of the session to a capture file (layout in
+// wt9011_capture.h); a null path stops capturing and closes the file
+WT9011_API bool wt9011_session_capture(wt9011_session* session, const char* path);
+
+// Session fed from a capture file instead of BLE; needs no wt9011_init.
+// Playback starts with wt9011_session_receive. speed: 1 = real time, N = N times
+// faster, <= 0 = as fast as possible. With `loop` the capture repeats until closed.
+WT9011_API wt9011_session* wt9011_replay_open(const char* path, double speed, bool loop);
+// True once a non-looping replay has delivered the whole capture
+WT9011_API bool wt9011_replay_done(wt9011_session* session);
+
+// Simulated sensor with options "rate=500,jitter_us=200,loss=0.01,seed=1"
+// (see wt9011_sim.h); needs no wt9011_init. Addresses "SIM:<n>" passed to
+// wt9011_open / wt9011_connect also give a simulator, configured by WT9011_SIM.
+WT9011_API wt9011_session* wt9011_sim_open(const char* options, unsigned device_index);
+
+WT9011_API unsigned long long wt9011_session_dropped_samples(wt9011_session* session);
+WT9011_API unsigned long long wt9011_session_discarded_bytes(wt9011_session* session);
+
+// Process-wide receive pipeline statistics, safe to call from any thread
+WT9011_API PipelineStats wt9011_get_stats();
+WT9011_API void wt9011_reset_stats();
+
+// Library log (see wt9011_log.h). Levels: 0 trace, 1 debug, 2 info, 3 warning,
+// 4 error, 5 off; levels below WT9011_LOG_LEVEL are not compiled in at all.
+WT9011_API void wt9011_log_set_level(int level);
+// Append the log to `path`; null or "" writes to stderr
+WT9011_API bool wt9011_log_open(const char* path);
+// Trace every received notification of every session to `path` in the capture
+// format, readable by wt9011_replay_open; null or "" stops tracing
+WT9011_API bool wt9011_log_trace_packets(const char* path);
+// Log records and traced packets lost because the ring was full
+WT9011_API unsigned long long wt9011_log_dropped();
+
+// Streams samples of any number of sessions to one columnar recording file
+// (layout in wt9011_recorder.h). Memory use is constant while recording.
+typedef struct wt9011_recorder wt9011_recorder;
+
+WT9011_API wt9011_recorder* wt9011_recorder_open(const char* path);
+// Record the session's samples into `recorder`; a null recorder stops recording
+WT9011_API bool wt9011_session_record(wt9011_session* session, wt9011_recorder* recorder);
+// Flush, write the footer index and free the handle; false if any write failed
+WT9011_API bool wt9011_recorder_close(wt9011_recorder* recorder);
+WT9011_API unsigned long long wt9011_recorder_samples(const wt9011_recorder* recorder);
+// Samples lost because the disk fell behind
+WT9011_API unsigned long long wt9011_recorder_dropped(const wt9011_recorder* recorder);
+
+// Memory-mapped, read-only view of a recording
+typedef struct wt9011_recording wt9011_recording;
+
+WT9011_API wt9011_recording* wt9011_recording_open(const char* path);
+WT9011_API void wt9011_recording_close(wt9011_recording* recording);
+WT9011_API size_t wt9011_recording_chunk_count(const wt9011_recording* recording);
+// Column pointers stay valid until wt9011_recording_close
+WT9011_API bool wt9011_recording_chunk(const wt9011_recording* recording, size_t index, RecordingChunk* out);
+WT9011_API size_t wt9011_recording_sensor_count(const wt9011_recording* recording);
+// Address of the sensor behind RecordingChunk::sensor_id, or null
+WT9011_API const char* wt9011_recording_sensor(const wt9011_recording* recording, unsigned int sensor_id);
+
+#endif // WT9011_API_H
@@ -0,0 +1,114 @@
+#ifndef WT9011_ASSEMBLER_H
+#define WT9011_ASSEMBLER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "wt9011_decoder.h"
+
+namespace wt9011 {
+
+// Reassembles 20-byte frames from a BLE notification byte stream.
+//
+// Notifications may carry part of a frame, several frames, or garbage between
+// frames. Complete frames are handed out straight from the notification buffer;
+// only a trailing partial frame is copied into a fixed carry buffer, so a
+// connection never needs more than one frame of storage. Bytes that cannot
+// start a frame are skipped up to the next 0x55 header and counted, both in
+// bytes and as one rejected frame per resynchronization.
+class FrameAssembler {
+public:
+    // Feed one notification. Calls on_frame(const std::uint8_t* frame) for every
+    // complete frame, in order; the pointer is valid only during the call.
+    // Returns the number of frames emitted.
+    template <typename OnFrame>
+    std::size_t feed(const std::uint8_t* data, std::size_t length, OnFrame&& on_frame) {
+        std::size_t emitted = 0;
+
+        // Complete the frame carried over from the previous notification
+        while (carried_ > 0 && length > 0) {
+            std::size_t take = kFrameSize - carried_;
+            if (take > length) take = length;
+            std::memcpy(carry_.data() + carried_, data, take);
+            carried_ += take;
+            data += take;
+            length -= take;
+
+            if (!prefix_valid(carry_.data(), carried_)) {
+                resync_carry();
+                continue;
+            }
+            if (carried_ == kFrameSize) {
+                on_frame(static_cast<const std::uint8_t*>(carry_.data()));
+                ++emitted;
+                carried_ = 0;
+            }
+        }
+
+        // Emit whole frames in place, resynchronizing on the 0x55 header
+        while (length > 0) {
+            if (!prefix_valid(data, length < 2 ? length : 2)) {
+                const void* next = length > 1 ? std::memchr(data + 1, kFrameHeader, length - 1) : nullptr;
+                std::size_t skip = next ? static_cast<std::size_t>(static_cast<const std::uint8_t*>(next) - data)
+                                        : length;
+                discarded_.fetch_add(skip, std::memory_order_relaxed);
+                resyncs_.fetch_add(1, std::memory_order_relaxed);
+                data += skip;
+                length -= skip;
+                continue;
+            }
+            if (length < kFrameSize) {
+                std::memcpy(carry_.data(), data, length);
+                carried_ = length;
+                break;
+            }
+            on_frame(data);
+            ++emitted;
+            data += kFrameSize;
+            length -= kFrameSize;
+        }
+
+        frames_.fetch_add(emitted, std::memory_order_relaxed);
+        return emitted;
+    }
+
+    // Bytes of a partial frame waiting for the next notification
+    std::size_t pending() const { return carried_; }
+
+    // Drop any partial frame, e.g. after reconnecting
+    void reset() {
+        carried_ = 0;
+    }
+
+    std::uint64_t frames() const { return frames_.load(std::memory_order_relaxed); }
+    std::uint64_t discarded_bytes() const { return discarded_.load(std::memory_order_relaxed); }
+    // Times the stream had to be resynchronized on a header
+    std::uint64_t resyncs() const { return resyncs_.load(std::memory_order_relaxed); }
+
+private:
+    static bool prefix_valid(const std::uint8_t* p, std::size_t n) {
+        return (n < 1 || p[0] == kFrameHeader) && (n < 2 || is_known_frame_type(p[1]));
+    }
+
+    // Drop the bad header byte and everything up to the next 0x55 in the carry
+    void resync_carry() {
+        std::size_t skip = 1;
+        while (skip < carried_ && carry_[skip] != kFrameHeader) ++skip;
+        discarded_.fetch_add(skip, std::memory_order_relaxed);
+        resyncs_.fetch_add(1, std::memory_order_relaxed);
+        carried_ -= skip;
+        std::memmove(carry_.data(), carry_.data() + skip, carried_);
+    }
+
+    std::array<std::uint8_t, kFrameSize> carry_{};
+    std::size_t carried_ = 0;
+    std::atomic<std::uint64_t> frames_{0};
+    std::atomic<std::uint64_t> discarded_{0};
+    std::atomic<std::uint64_t> resyncs_{0};
+};
+
+} // namespace wt9011
+
+#endif // WT9011_ASSEMBLER_H
@@ -0,0 +1,196 @@
+#ifndef WT9011_BATCH_H
+#define WT9011_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include "wt9011_types.h"
+#include "wt9011_decoder.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WT9011_HAVE_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define WT9011_TARGET_AVX2
+#else
+#define WT9011_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace wt9011 {
+
+// Decodes `count` contiguous data frames (kFrameSize bytes each) into SoA
+// arrays. Frames are not validated here; see decode_frames_soa.
+using BatchDecodeFn = void (*)(const std::uint8_t* frames, std::size_t count, const SensorDataSoA& out);
+
+inline void decode_frames_scalar(const std::uint8_t* frames, std::size_t count, const SensorDataSoA& out) {
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint8_t* f = frames + i * kFrameSize;
+        out.ax[i] = read_i16(f + 2) * kAccelScale;
+        out.ay[i] = read_i16(f + 4) * kAccelScale;
+        out.az[i] = read_i16(f + 6) * kAccelScale;
+        out.gx[i] = read_i16(f + 8) * kGyroScale;
+        out.gy[i] = read_i16(f + 10) * kGyroScale;
+        out.gz[i] = read_i16(f + 12) * kGyroScale;
+        out.roll[i] = read_i16(f + 14) * kAngleScale;
+        out.pitch[i] = read_i16(f + 16) * kAngleScale;
+        out.yaw[i] = wrap_yaw(read_i16(f + 18) * kAngleScale);
+    }
+}
+
+#if defined(WT9011_HAVE_SSE2)
+
+namespace detail {
+
+// Loads 8 frames and transposes them into one int16x8 vector per channel
+// (ax, ay, az, gx, gy, gz, roll, pitch, yaw), frame j in lane j.
+inline void load_channels_8(const std::uint8_t* f, __m128i ch[9]) {
+    __m128i r[8];
+    for (int j = 0; j < 8; ++j) {
+        // Bytes 4..19: ay .. yaw; keeps the load inside the frame
+        r[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(f + j * kFrameSize + 4));
+    }
+    __m128i t0 = _mm_unpacklo_epi16(r[0], r[1]), t1 = _mm_unpackhi_epi16(r[0], r[1]);
+    __m128i t2 = _mm_unpacklo_epi16(r[2], r[3]), t3 = _mm_unpackhi_epi16(r[2], r[3]);
+    __m128i t4 = _mm_unpacklo_epi16(r[4], r[5]), t5 = _mm_unpackhi_epi16(r[4], r[5]);
+    __m128i t6 = _mm_unpacklo_epi16(r[6], r[7]), t7 = _mm_unpackhi_epi16(r[6], r[7]);
+    __m128i u0 = _mm_unpacklo_epi32(t0, t2), u1 = _mm_unpackhi_epi32(t0, t2);
+    __m128i u2 = _mm_unpacklo_epi32(t1, t3), u3 = _mm_unpackhi_epi32(t1, t3);
+    __m128i u4 = _mm_unpacklo_epi32(t4, t6), u5 = _mm_unpackhi_epi32(t4, t6);
+    __m128i u6 = _mm_unpacklo_epi32(t5, t7), u7 = _mm_unpackhi_epi32(t5, t7);
+    ch[1] = _mm_unpacklo_epi64(u0, u4);
+    ch[2] = _mm_unpackhi_epi64(u0, u4);
+    ch[3] = _mm_unpacklo_epi64(u1, u5);
+    ch[4] = _mm_unpackhi_epi64(u1, u5);
+    ch[5] = _mm_unpacklo_epi64(u2, u6);
+    ch[6] = _mm_unpackhi_epi64(u2, u6);
+    ch[7] = _mm_unpacklo_epi64(u3, u7);
+    ch[8] = _mm_unpackhi_epi64(u3, u7);
+    ch[0] = _mm_set_epi16(read_i16(f + 7 * kFrameSize + 2), read_i16(f + 6 * kFrameSize + 2),
+                          read_i16(f + 5 * kFrameSize + 2), read_i16(f + 4 * kFrameSize + 2),
+                          read_i16(f + 3 * kFrameSize + 2), read_i16(f + 2 * kFrameSize + 2),
+                          read_i16(f + 1 * kFrameSize + 2), read_i16(f + 0 * kFrameSize + 2));
+}
+
+inline void channel_outputs(const SensorDataSoA& out, float* (&dst)[9]) {
+    dst[0] = out.ax; dst[1] = out.ay; dst[2] = out.az;
+    dst[3] = out.gx; dst[4] = out.gy; dst[5] = out.gz;
+    dst[6] = out.roll; dst[7] = out.pitch; dst[8] = out.yaw;
+}
+
+inline SensorDataSoA offset_outputs(const SensorDataSoA& out, std::size_t i) {
+    return { out.ax + i, out.ay + i, out.az + i, out.gx + i, out.gy + i, out.gz + i,
+             out.roll + i, out.pitch + i, out.yaw + i };
+}
+
+constexpr float kChannelScale[9] = { kAccelScale, kAccelScale, kAccelScale,
+                                     kGyroScale, kGyroScale, kGyroScale,
+                                     kAngleScale, kAngleScale, kAngleScale };
+
+inline __m128 wrap_yaw_ps(__m128 v) {
+    __m128 over = _mm_cmpgt_ps(v, _mm_set1_ps(180.0f));
+    return _mm_sub_ps(v, _mm_and_ps(over, _mm_set1_ps(360.0f)));
+}
+
+WT9011_TARGET_AVX2 inline __m256 wrap_yaw_ps(__m256 v) {
+    __m256 over = _mm256_cmp_ps(v, _mm256_set1_ps(180.0f), _CMP_GT_OQ);
+    return _mm256_sub_ps(v, _mm256_and_ps(over, _mm256_set1_ps(360.0f)));
+}
+
+} // namespace detail
+
+inline void decode_frames_sse2(const std::uint8_t* frames, std::size_t count, const SensorDataSoA& out) {
+    float* dst[9];
+    detail::channel_outputs(out, dst);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i ch[9];
+        detail::load_channels_8(frames + i * kFrameSize, ch);
+        for (int c = 0; c < 9; ++c) {
+            // Sign-extend int16 -> int32 by unpacking into the high half and shifting back
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(ch[c], ch[c]), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(ch[c], ch[c]), 16);
+            __m128 scale = _mm_set1_ps(detail::kChannelScale[c]);
+            __m128 flo = _mm_mul_ps(_mm_cvtepi32_ps(lo), scale);
+            __m128 fhi = _mm_mul_ps(_mm_cvtepi32_ps(hi), scale);
+            if (c == 8) {
+                flo = detail::wrap_yaw_ps(flo);
+                fhi = detail::wrap_yaw_ps(fhi);
+            }
+            _mm_storeu_ps(dst[c] + i, flo);
+            _mm_storeu_ps(dst[c] + i + 4, fhi);
+        }
+    }
+    if (i < count) {
+        decode_frames_scalar(frames + i * kFrameSize, count - i, detail::offset_outputs(out, i));
+    }
+}
+
+WT9011_TARGET_AVX2 inline void decode_frames_avx2(const std::uint8_t* frames, std::size_t count,
+                                                   const SensorDataSoA& out) {
+    float* dst[9];
+    detail::channel_outputs(out, dst);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i ch[9];
+        detail::load_channels_8(frames + i * kFrameSize, ch);
+        for (int c = 0; c < 9; ++c) {
+            __m256 v = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(ch[c])),
+                                     _mm256_set1_ps(detail::kChannelScale[c]));
+            if (c == 8) {
+                v = detail::wrap_yaw_ps(v);
+            }
+            _mm256_storeu_ps(dst[c] + i, v);
+        }
+    }
+    if (i < count) {
+        decode_frames_scalar(frames + i * kFrameSize, count - i, detail::offset_outputs(out, i));
+    }
+}
+
+inline bool cpu_has_avx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // WT9011_HAVE_SSE2
+
+// Picks the widest implementation the CPU supports, once per process
+inline BatchDecodeFn select_batch_decoder() {
+#if defined(WT9011_HAVE_SSE2)
+    return cpu_has_avx2() ? &decode_frames_avx2 : &decode_frames_sse2;
+#else
+    return &decode_frames_scalar;
+#endif
+}
+
+// Decodes the leading run of valid 0x55 0x61 frames in `frames` into `out`.
+// Returns the number of frames decoded; stops at the first invalid header.
+inline std::size_t decode_frames_soa(const std::uint8_t* frames, std::size_t count, const SensorDataSoA& out) {
+    static const BatchDecodeFn decode = select_batch_decoder();
+    std::size_t valid = 0;
+    while (valid < count && frames[valid * kFrameSize] == kFrameHeader &&
+           frames[valid * kFrameSize + 1] == kFrameTypeData) {
+        ++valid;
+    }
+    if (valid > 0) {
+        decode(frames, valid, out);
+    }
+    return valid;
+}
+
+} // namespace wt9011
+
+#endif // WT9011_BATCH_H
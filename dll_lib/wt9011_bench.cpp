@@ -0,0 +1,233 @@
+// Benchmarks of the receive pipeline: the Python parse path, the native
+// decoders, per-sample dispatch and notify -> callback latency through the
+// simulator. Results are JSON unless --benchmark_format is given:
+//
+//   wt9011_bench --benchmark_out=before.json --benchmark_out_format=json
+//   compare.py benchmarks before.json after.json   (from Google Benchmark tools)
+#include <benchmark/benchmark.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/embed.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "wt9011_types.h"
+#include "wt9011_api.h"
+#include "wt9011_assembler.h"
+#include "wt9011_batch.h"
+#include "wt9011_clock.h"
+#include "wt9011_decoder.h"
+#include "wt9011_session.h"
+
+namespace py = pybind11;
+
+// Defined in wt9011_dll.cpp
+SensorData convert_to_sensor_data(py::dict data);
+
+namespace {
+
+constexpr std::size_t kFramePool = 256;
+
+// Back-to-back frames with varied values
+std::vector<std::uint8_t> make_frames(std::size_t count) {
+    std::vector<std::uint8_t> frames(count * wt9011::kFrameSize);
+    for (std::size_t i = 0; i < count; ++i) {
+        const float t = static_cast<float>(i) * 0.01f;
+        SensorData data;
+        data.accel = { std::sin(t), std::cos(t), 1.0f - 0.1f * std::sin(3.0f * t) };
+        data.gyro = { 100.0f * std::cos(t), -50.0f * std::sin(t), 36.0f };
+        data.angle = { 30.0f * std::sin(t), 20.0f * std::cos(t), std::fmod(36.0f * t, 360.0f) - 180.0f };
+        wt9011::encode_frame(data, frames.data() + i * wt9011::kFrameSize);
+    }
+    return frames;
+}
+
+// WT9011Parser.parse + convert_to_sensor_data, as wt9011_receive did before the native decoder
+void BM_PythonParseConvert(benchmark::State& state) {
+    py::object parse = py::module_::import("sensor_parser").attr("WT9011Parser").attr("parse");
+    const std::vector<std::uint8_t> frames = make_frames(kFramePool);
+    std::vector<py::bytearray> payloads;
+    for (std::size_t i = 0; i < kFramePool; ++i) {
+        payloads.emplace_back(reinterpret_cast<const char*>(frames.data() + i * wt9011::kFrameSize), wt9011::kFrameSize);
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        py::object parsed = parse(payloads[i++ % kFramePool]);
+        SensorData data = convert_to_sensor_data(parsed.cast<py::dict>());
+        benchmark::DoNotOptimize(data);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PythonParseConvert);
+
+void BM_DecodeFrame(benchmark::State& state) {
+    const std::vector<std::uint8_t> frames = make_frames(kFramePool);
+    std::size_t i = 0;
+    SensorData data;
+    for (auto _ : state) {
+        wt9011::decode_frame(frames.data() + (i++ % kFramePool) * wt9011::kFrameSize, wt9011::kFrameSize, data);
+        benchmark::DoNotOptimize(data);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DecodeFrame);
+
+void BM_DecodeBatch(benchmark::State& state, wt9011::BatchDecodeFn decode) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::vector<std::uint8_t> frames = make_frames(count);
+    std::vector<float> columns(9 * count);
+    const SensorDataSoA out = { &columns[0], &columns[count], &columns[2 * count], &columns[3 * count],
+                                &columns[4 * count], &columns[5 * count], &columns[6 * count],
+                                &columns[7 * count], &columns[8 * count] };
+    for (auto _ : state) {
+        decode(frames.data(), count, out);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+BENCHMARK_CAPTURE(BM_DecodeBatch, scalar, wt9011::decode_frames_scalar)->Arg(64)->Arg(1024);
+#if defined(WT9011_HAVE_SSE2)
+BENCHMARK_CAPTURE(BM_DecodeBatch, sse2, wt9011::decode_frames_sse2)->Arg(64)->Arg(1024);
+#endif
+
+void BM_DecodeBatchAvx2(benchmark::State& state) {
+#if defined(WT9011_HAVE_SSE2)
+    if (!wt9011::cpu_has_avx2()) {
+        state.SkipWithError("AVX2 not supported");
+        return;
+    }
+    BM_DecodeBatch(state, wt9011::decode_frames_avx2);
+#else
+    state.SkipWithError("x86 only");
+#endif
+}
+BENCHMARK(BM_DecodeBatchAvx2)->Arg(64)->Arg(1024);
+
+// Reassembly of a stream cut into 7-byte notifications
+void BM_AssemblerFeed(benchmark::State& state) {
+    const std::vector<std::uint8_t> stream = make_frames(kFramePool);
+    wt9011::FrameAssembler assembler;
+    std::size_t frames = 0;
+    for (auto _ : state) {
+        for (std::size_t offset = 0; offset < stream.size(); offset += 7) {
+            const std::size_t length = std::min<std::size_t>(7, stream.size() - offset);
+            assembler.feed(stream.data() + offset, length, [&frames](const std::uint8_t*) { ++frames; });
+        }
+    }
+    benchmark::DoNotOptimize(frames);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kFramePool));
+}
+BENCHMARK(BM_AssemblerFeed);
+
+void count_sample(wt9011_session*, const SensorSample* sample, void* user) {
+    benchmark::DoNotOptimize(sample->data);
+    ++*static_cast<std::size_t*>(user);
+}
+
+// One notification through reassembly, decoding and the user callback
+void BM_DispatchCallback(benchmark::State& state) {
+    const std::vector<std::uint8_t> frames = make_frames(kFramePool);
+    wt9011_session session("bench");
+    std::size_t delivered = 0;
+    session.callback = count_sample;
+    session.user = &delivered;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        session.on_notification(frames.data() + (i % kFramePool) * wt9011::kFrameSize, wt9011::kFrameSize, i);
+        ++i;
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(delivered));
+}
+BENCHMARK(BM_DispatchCallback);
+
+// Same, delivering into the poll queue and draining it in batches
+void BM_DispatchQueue(benchmark::State& state) {
+    const std::vector<std::uint8_t> frames = make_frames(kFramePool);
+    wt9011_session session("bench");
+    std::vector<SensorSample> drained(kFramePool);
+    std::size_t i = 0;
+    std::size_t delivered = 0;
+    for (auto _ : state) {
+        session.on_notification(frames.data() + (i % kFramePool) * wt9011::kFrameSize, wt9011::kFrameSize, i);
+        if (++i % kFramePool == 0) {
+            delivered += wt9011_session_poll_samples(&session, drained.data(), drained.size());
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(delivered));
+}
+BENCHMARK(BM_DispatchQueue);
+
+struct LatencyProbe {
+    std::vector<std::uint64_t> latencies;
+    std::atomic<std::size_t> count{0};
+};
+
+void record_latency(wt9011_session*, const SensorSample* sample, void* user) {
+    const std::uint64_t now = wt9011::monotonic_ns();
+    auto* probe = static_cast<LatencyProbe*>(user);
+    const std::size_t i = probe->count.fetch_add(1, std::memory_order_relaxed);
+    if (i < probe->latencies.size()) {
+        probe->latencies[i] = now - sample->timestamp_ns;
+    }
+}
+
+// Notify -> callback latency through the simulator at state.range(0) Hz.
+// Each iteration waits for 1000 samples; percentiles cover all of them.
+void BM_EndToEndSim(benchmark::State& state) {
+    constexpr std::size_t kBatch = 1000;
+    const std::string options = "rate=" + std::to_string(state.range(0));
+    wt9011_session* session = wt9011_sim_open(options.c_str(), 0);
+    if (!session) {
+        state.SkipWithError("simulator unavailable");
+        return;
+    }
+    LatencyProbe probe;
+    probe.latencies.resize(kBatch);
+    std::vector<std::uint64_t> all;
+    wt9011_session_receive(session, record_latency, &probe);
+    for (auto _ : state) {
+        probe.count.store(0, std::memory_order_relaxed);
+        while (probe.count.load(std::memory_order_relaxed) < kBatch) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        all.insert(all.end(), probe.latencies.begin(), probe.latencies.end());
+    }
+    wt9011_close(session);
+
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](double p) {
+        return all.empty() ? 0.0 : static_cast<double>(all[static_cast<std::size_t>(p * (all.size() - 1))]);
+    };
+    state.counters["latency_p50_ns"] = percentile(0.50);
+    state.counters["latency_p99_ns"] = percentile(0.99);
+    state.counters["latency_max_ns"] = percentile(1.0);
+    state.SetItemsProcessed(static_cast<std::int64_t>(all.size()));
+}
+BENCHMARK(BM_EndToEndSim)->Arg(1000)->Arg(20000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+    static char json_format[] = "--benchmark_format=json";
+    const bool has_format = std::any_of(args.begin() + 1, args.end(), [](const char* arg) {
+        return std::strncmp(arg, "--benchmark_format", 18) == 0;
+    });
+    if (!has_format) {
+        args.push_back(json_format);
+    }
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+
+    py::scoped_interpreter interpreter;
+    py::module_::import("sys").attr("path").attr("append")(WT9011_PYTHON_LIB_DIR);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "wt9011_capture.h"
+#include <cstring>
+
+namespace wt9011 {
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+bool CaptureWriter::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+        return false;
+    }
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+    buffer_.resize(1 << 16);
+    std::setvbuf(file_, buffer_.data(), _IOFBF, buffer_.size());
+
+    std::uint8_t header[kCaptureHeaderSize] = {};
+    std::memcpy(header, kCaptureMagic, sizeof(kCaptureMagic));
+    std::memcpy(header + 8, &kCaptureVersion, sizeof(kCaptureVersion));
+    failed_ = std::fwrite(header, sizeof(header), 1, file_) != 1;
+    open_.store(true, std::memory_order_release);
+    return true;
+}
+
+bool CaptureWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) {
+        return false;
+    }
+    open_.store(false, std::memory_order_release);
+    bool ok = std::fclose(file_) == 0 && !failed_;
+    file_ = nullptr;
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    return ok;
+}
+
+void CaptureWriter::append(std::uint64_t timestamp_ns, const std::uint8_t* data, std::size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_ || failed_) {
+        return;
+    }
+    std::uint8_t header[kCaptureRecordHeaderSize];
+    const std::uint32_t size = static_cast<std::uint32_t>(length);
+    std::memcpy(header, &timestamp_ns, 8);
+    std::memcpy(header + 8, &size, 4);
+    if (std::fwrite(header, sizeof(header), 1, file_) != 1 ||
+        (length > 0 && std::fwrite(data, 1, length, file_) != length)) {
+        failed_ = true;
+    }
+}
+
+CaptureCursor::CaptureCursor(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {
+    std::uint32_t version = 0;
+    if (data_ && size_ >= kCaptureHeaderSize && std::memcmp(data_, kCaptureMagic, sizeof(kCaptureMagic)) == 0) {
+        std::memcpy(&version, data_ + 8, sizeof(version));
+    }
+    valid_ = version == kCaptureVersion;
+}
+
+bool CaptureCursor::next(CaptureRecord& record) {
+    if (!valid_ || size_ - position_ < kCaptureRecordHeaderSize) {
+        return false;
+    }
+    std::uint32_t length = 0;
+    std::memcpy(&record.timestamp_ns, data_ + position_, 8);
+    std::memcpy(&length, data_ + position_ + 8, 4);
+    if (size_ - position_ - kCaptureRecordHeaderSize < length) {
+        return false;
+    }
+    record.data = data_ + position_ + kCaptureRecordHeaderSize;
+    record.length = length;
+    position_ += kCaptureRecordHeaderSize + length;
+    return true;
+}
+
+} // namespace wt9011
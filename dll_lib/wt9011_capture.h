@@ -0,0 +1,75 @@
+#ifndef WT9011_CAPTURE_H
+#define WT9011_CAPTURE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wt9011 {
+
+// Raw notification capture file (little endian):
+//
+//   magic "WT9011CP", u32 version, u32 reserved        16 bytes
+//   repeated: u64 timestamp_ns, u32 length, u8[length]
+//
+// Notifications are stored exactly as received, before frame reassembly,
+// so replaying a capture exercises the whole receive path.
+
+constexpr char kCaptureMagic[8] = {'W', 'T', '9', '0', '1', '1', 'C', 'P'};
+constexpr std::uint32_t kCaptureVersion = 1;
+constexpr std::size_t kCaptureHeaderSize = 16;
+constexpr std::size_t kCaptureRecordHeaderSize = 12;
+
+// Appends notifications of one session to a capture file
+class CaptureWriter {
+public:
+    CaptureWriter() = default;
+    ~CaptureWriter();
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool open(const std::string& path);
+    // False if any write failed
+    bool close();
+    void append(std::uint64_t timestamp_ns, const std::uint8_t* data, std::size_t length);
+
+    bool is_open() const { return open_.load(std::memory_order_acquire); }
+
+private:
+    std::mutex mutex_;
+    std::FILE* file_ = nullptr;
+    std::vector<char> buffer_;
+    std::atomic<bool> open_{false};
+    bool failed_ = false;
+};
+
+struct CaptureRecord {
+    std::uint64_t timestamp_ns;
+    const std::uint8_t* data;
+    std::size_t length;
+};
+
+// Walks the records of a capture held in memory (typically a MappedFile)
+class CaptureCursor {
+public:
+    CaptureCursor(const std::uint8_t* data, std::size_t size);
+
+    bool valid() const { return valid_; }
+    // False at the end or at a truncated record
+    bool next(CaptureRecord& record);
+    void rewind() { position_ = kCaptureHeaderSize; }
+
+private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t position_ = kCaptureHeaderSize;
+    bool valid_ = false;
+};
+
+} // namespace wt9011
+
+#endif // WT9011_CAPTURE_H
@@ -0,0 +1,17 @@
+#ifndef WT9011_CLOCK_H
+#define WT9011_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace wt9011 {
+
+// Monotonic time in nanoseconds; the clock behind SensorSample::timestamp_ns
+inline std::uint64_t monotonic_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace wt9011
+
+#endif // WT9011_CLOCK_H
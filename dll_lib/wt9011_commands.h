@@ -0,0 +1,93 @@
+#ifndef WT9011_COMMANDS_H
+#define WT9011_COMMANDS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wt9011 {
+
+// Register write: 0xFF 0xAA, register, value low byte, value high byte
+constexpr std::uint8_t kCommandHeader0 = 0xFF;
+constexpr std::uint8_t kCommandHeader1 = 0xAA;
+constexpr std::size_t kCommandSize = 5;
+
+// Registers used by the wrappers in wt9011_api.h; any other register of the
+// WitMotion map can be written with wt9011_write_register
+constexpr std::uint8_t kRegSave = 0x00;
+constexpr std::uint8_t kRegCalibration = 0x01;
+constexpr std::uint8_t kRegFactoryReset = 0x03;
+constexpr std::uint8_t kRegSleep = 0x06;
+constexpr std::uint8_t kRegAccelEnable = 0x10;
+constexpr std::uint8_t kRegGyroEnable = 0x11;
+constexpr std::uint8_t kRegReturnRate = 0x15;
+constexpr std::uint8_t kRegReadRegister = 0x27; // Value: register to read
+constexpr std::uint8_t kRegZeroing = 0x52;
+constexpr std::uint8_t kRegUnlock = 0x69;
+
+constexpr std::uint16_t kUnlockKey = 0xB588;
+constexpr int kMinReturnRateHz = 1;
+constexpr int kMaxReturnRateHz = 100;
+
+struct Command {
+    std::uint8_t bytes[kCommandSize];
+
+    constexpr std::uint8_t reg() const { return bytes[2]; }
+    constexpr std::uint16_t value() const {
+        return static_cast<std::uint16_t>(bytes[3] | (bytes[4] << 8));
+    }
+};
+
+constexpr Command encode_command(std::uint8_t reg, std::uint16_t value) {
+    return Command{{kCommandHeader0, kCommandHeader1, reg, static_cast<std::uint8_t>(value & 0xFF),
+                    static_cast<std::uint8_t>(value >> 8)}};
+}
+
+// Decode a 5-byte register write, or the 4-byte form with an 8-bit value
+// that older firmware and sensor_commands.py used
+constexpr bool decode_command(const std::uint8_t* data, std::size_t length, std::uint8_t& reg,
+                              std::uint16_t& value) {
+    if (!data || (length != kCommandSize && length != kCommandSize - 1) || data[0] != kCommandHeader0 ||
+        data[1] != kCommandHeader1) {
+        return false;
+    }
+    reg = data[2];
+    value = static_cast<std::uint16_t>(length == kCommandSize ? data[3] | (data[4] << 8) : data[3]);
+    return true;
+}
+
+constexpr bool is_valid_return_rate(int rate_hz) {
+    return rate_hz >= kMinReturnRateHz && rate_hz <= kMaxReturnRateHz;
+}
+
+constexpr Command kCommandZeroing = encode_command(kRegZeroing, 0);
+constexpr Command kCommandCalibration = encode_command(kRegCalibration, 0);
+constexpr Command kCommandSaveSettings = encode_command(kRegSave, 0);
+constexpr Command kCommandFactoryReset = encode_command(kRegFactoryReset, 0);
+constexpr Command kCommandSleep = encode_command(kRegSleep, 0);
+constexpr Command kCommandWakeup = encode_command(kRegSleep, 1);
+constexpr Command kCommandUnlock = encode_command(kRegUnlock, kUnlockKey);
+
+constexpr Command command_accel_enable(bool enable) {
+    return encode_command(kRegAccelEnable, enable ? 1 : 0);
+}
+
+constexpr Command command_gyro_enable(bool enable) {
+    return encode_command(kRegGyroEnable, enable ? 1 : 0);
+}
+
+// Answered with a 0x55 0x71 frame (see wt9011_decoder.h)
+constexpr Command command_read_register(std::uint8_t reg) {
+    return encode_command(kRegReadRegister, reg);
+}
+
+// Caller checks is_valid_return_rate
+constexpr Command command_set_return_rate(int rate_hz) {
+    return encode_command(kRegReturnRate, static_cast<std::uint16_t>(rate_hz));
+}
+
+static_assert(kCommandUnlock.bytes[3] == 0x88 && kCommandUnlock.bytes[4] == 0xB5, "value is little endian");
+static_assert(kCommandWakeup.reg() == kRegSleep && kCommandWakeup.value() == 1, "reg()/value() round trip");
+
+} // namespace wt9011
+
+#endif // WT9011_COMMANDS_H
@@ -0,0 +1,128 @@
+#ifndef WT9011_DECODER_H
+#define WT9011_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "wt9011_types.h"
+
+namespace wt9011 {
+
+// Data frame layout: 0x55 0x61, then accel, gyro and angle XYZ as int16 little-endian
+constexpr std::uint8_t kFrameHeader = 0x55;
+constexpr std::uint8_t kFrameTypeData = 0x61;
+constexpr std::size_t kFrameSize = 20;
+
+// Register read reply: 0x55 0x71, first register (u16), then that register
+// and the 7 following ones as u16 little-endian
+constexpr std::uint8_t kFrameTypeRegister = 0x71;
+constexpr std::size_t kRegisterReplyValues = 8;
+
+// Full-scale ranges: ±16 g, ±2000 °/s, ±180°
+constexpr float kAccelScale = 16.0f / 32768.0f;
+constexpr float kGyroScale = 2000.0f / 32768.0f;
+constexpr float kAngleScale = 180.0f / 32768.0f;
+
+// A notification holding a single data frame may append sum(frame) & 0xFF as
+// a 21st byte; WT9011Parser.parse rejected the frame when it did not match
+constexpr std::size_t kChecksummedFrameSize = kFrameSize + 1;
+
+inline std::uint8_t frame_checksum(const std::uint8_t* frame) {
+    unsigned sum = 0;
+    for (std::size_t i = 0; i < kFrameSize; ++i) {
+        sum += frame[i];
+    }
+    return static_cast<std::uint8_t>(sum & 0xFF);
+}
+
+// Frame types the stream assembler accepts after a 0x55 header
+inline bool is_known_frame_type(std::uint8_t type) {
+    return type == kFrameTypeData || type == kFrameTypeRegister;
+}
+
+inline std::int16_t read_i16(const std::uint8_t* p) {
+    return static_cast<std::int16_t>(static_cast<std::uint16_t>(p[0]) |
+                                     static_cast<std::uint16_t>(p[1] << 8));
+}
+
+// Map yaw into (-180, 180], same as WT9011Parser.parse
+inline float wrap_yaw(float yaw) {
+    return yaw > 180.0f ? yaw - 360.0f : yaw;
+}
+
+// Decode a single 0x55 0x61 frame. Returns false if the buffer is too short,
+// does not start with the data frame header, or is a checksummed frame
+// (kChecksummedFrameSize bytes) whose checksum does not match; `out` is left
+// untouched then.
+inline bool decode_frame(const std::uint8_t* data, std::size_t length, SensorData& out) {
+    if (length < kFrameSize || data[0] != kFrameHeader || data[1] != kFrameTypeData ||
+        (length == kChecksummedFrameSize && data[kFrameSize] != frame_checksum(data))) {
+        return false;
+    }
+    out.accel = { read_i16(data + 2) * kAccelScale,
+                  read_i16(data + 4) * kAccelScale,
+                  read_i16(data + 6) * kAccelScale };
+    out.gyro = { read_i16(data + 8) * kGyroScale,
+                 read_i16(data + 10) * kGyroScale,
+                 read_i16(data + 12) * kGyroScale };
+    out.angle = { read_i16(data + 14) * kAngleScale,
+                  read_i16(data + 16) * kAngleScale,
+                  wrap_yaw(read_i16(data + 18) * kAngleScale) };
+    return true;
+}
+
+inline void write_i16(std::uint8_t* p, std::int16_t value) {
+    p[0] = static_cast<std::uint8_t>(static_cast<std::uint16_t>(value) & 0xFF);
+    p[1] = static_cast<std::uint8_t>(static_cast<std::uint16_t>(value) >> 8);
+}
+
+// Physical value to raw int16; saturates outside the full-scale range
+inline std::int16_t to_raw(float value, float scale) {
+    const float raw = value / scale;
+    if (raw >= 32767.0f) {
+        return 32767;
+    }
+    if (raw <= -32768.0f) {
+        return -32768;
+    }
+    return static_cast<std::int16_t>(raw < 0.0f ? raw - 0.5f : raw + 0.5f);
+}
+
+// Inverse of decode_frame; writes kFrameSize bytes to `out`
+inline void encode_frame(const SensorData& in, std::uint8_t* out) {
+    out[0] = kFrameHeader;
+    out[1] = kFrameTypeData;
+    write_i16(out + 2, to_raw(in.accel.x, kAccelScale));
+    write_i16(out + 4, to_raw(in.accel.y, kAccelScale));
+    write_i16(out + 6, to_raw(in.accel.z, kAccelScale));
+    write_i16(out + 8, to_raw(in.gyro.x, kGyroScale));
+    write_i16(out + 10, to_raw(in.gyro.y, kGyroScale));
+    write_i16(out + 12, to_raw(in.gyro.z, kGyroScale));
+    write_i16(out + 14, to_raw(in.angle.roll, kAngleScale));
+    write_i16(out + 16, to_raw(in.angle.pitch, kAngleScale));
+    write_i16(out + 18, to_raw(in.angle.yaw, kAngleScale));
+}
+
+inline bool decode_register_frame(const std::uint8_t* data, std::size_t length, std::uint16_t& first,
+                                  std::uint16_t* values) {
+    if (length < kFrameSize || data[0] != kFrameHeader || data[1] != kFrameTypeRegister) {
+        return false;
+    }
+    first = static_cast<std::uint16_t>(read_i16(data + 2));
+    for (std::size_t i = 0; i < kRegisterReplyValues; ++i) {
+        values[i] = static_cast<std::uint16_t>(read_i16(data + 4 + 2 * i));
+    }
+    return true;
+}
+
+inline void encode_register_frame(std::uint16_t first, const std::uint16_t* values, std::uint8_t* out) {
+    out[0] = kFrameHeader;
+    out[1] = kFrameTypeRegister;
+    write_i16(out + 2, static_cast<std::int16_t>(first));
+    for (std::size_t i = 0; i < kRegisterReplyValues; ++i) {
+        write_i16(out + 4 + 2 * i, static_cast<std::int16_t>(values[i]));
+    }
+}
+
+} // namespace wt9011
+
+#endif // WT9011_DECODER_H
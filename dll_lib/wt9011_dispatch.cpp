@@ -0,0 +1,121 @@
+#include "wt9011_dispatch.h"
+#include <algorithm>
+#include "wt9011_session.h"
+
+namespace wt9011 {
+
+namespace {
+
+// Notifications delivered per turn before the worker moves to the next session
+constexpr std::size_t kDispatchBatch = 32;
+
+thread_local bool dispatch_thread = false;
+
+} // namespace
+
+Dispatcher::~Dispatcher() {
+    // stop() was never called (no wt9011_cleanup); joining from a DLL
+    // destructor can deadlock on Windows, so leave the threads be
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.detach();
+            worker.release();
+        }
+    }
+}
+
+std::size_t Dispatcher::assign() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (workers_.empty()) {
+        const unsigned cores = std::thread::hardware_concurrency();
+        const std::size_t count = std::max(1u, std::min(4u, cores / 2));
+        for (std::size_t i = 0; i < count; ++i) {
+            workers_.emplace_back(new Worker());
+        }
+        for (auto& worker : workers_) {
+            Worker* w = worker.get();
+            w->thread = std::thread([this, w]() { run(*w); });
+        }
+    }
+    return next_++ % workers_.size();
+}
+
+void Dispatcher::post(const std::shared_ptr<wt9011_session>& session) {
+    // Pairs with the fence in run(): either the worker sees the packet just
+    // pushed, or we see the flag it cleared and queue the session again
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (session->scheduled.exchange(true)) {
+        return;
+    }
+    std::unique_lock<std::mutex> pool(mutex_);
+    if (session->worker >= workers_.size()) {
+        session->scheduled.store(false);
+        return;
+    }
+    Worker& worker = *workers_[session->worker];
+    pool.unlock();
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.ready.push_back(session);
+    }
+    worker.wake.notify_one();
+}
+
+void Dispatcher::stop() {
+    std::vector<std::unique_ptr<Worker>> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workers.swap(workers_);
+        next_ = 0;
+    }
+    for (auto& worker : workers) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->stopping = true;
+        }
+        worker->wake.notify_one();
+        worker->thread.join();
+        for (auto& session : worker->ready) {
+            session->scheduled.store(false);
+        }
+    }
+}
+
+bool Dispatcher::on_worker_thread() {
+    return dispatch_thread;
+}
+
+void Dispatcher::run(Worker& worker) {
+    dispatch_thread = true;
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    for (;;) {
+        worker.wake.wait(lock, [&worker]() { return worker.stopping || !worker.ready.empty(); });
+        if (worker.stopping) {
+            return;
+        }
+        std::shared_ptr<wt9011_session> session = std::move(worker.ready.front());
+        worker.ready.pop_front();
+        lock.unlock();
+
+        bool more = session->drain_packets(kDispatchBatch);
+        if (!more) {
+            session->scheduled.store(false);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // A packet that raced with the flag; reclaim the session unless
+            // post() already did
+            more = session->packets.size() > 0 && !session->scheduled.exchange(true);
+        }
+
+        lock.lock();
+        if (more) {
+            worker.ready.push_back(std::move(session));
+        }
+    }
+}
+
+Dispatcher& dispatcher() {
+    static Dispatcher instance;
+    return instance;
+}
+
+} // namespace wt9011
@@ -0,0 +1,73 @@
+#ifndef WT9011_DISPATCH_H
+#define WT9011_DISPATCH_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct wt9011_session;
+
+namespace wt9011 {
+
+// Largest notification payload: the largest ATT_MTU (517) less the 3-byte
+// notification header. Every notification of a standard link fits one packet.
+constexpr std::size_t kMaxNotification = 514;
+
+// One notification copied out of its Python buffer
+struct RawPacket {
+    std::uint64_t timestamp_ns;
+    std::uint16_t length;
+    std::uint8_t data[kMaxNotification];
+};
+
+// Small pool of native threads that decode BLE notifications and run the
+// consumer callbacks, so neither ever holds the GIL.
+//
+// The bleak handler only copies each notification into its session's packet
+// ring and posts the session here. Every session is pinned to one worker,
+// which keeps its samples in order; sessions sharing a worker take turns in
+// batches so one busy sensor cannot starve the others.
+class Dispatcher {
+public:
+    Dispatcher() = default;
+    Dispatcher(const Dispatcher&) = delete;
+    Dispatcher& operator=(const Dispatcher&) = delete;
+    ~Dispatcher();
+
+    // Pick the worker for a new session, starting the pool if needed
+    std::size_t assign();
+    // Queue the session's pending packets; any thread
+    void post(const std::shared_ptr<wt9011_session>& session);
+    // Join the workers; sessions still queued are dropped
+    void stop();
+
+    // True on a worker thread, i.e. inside a consumer callback
+    static bool on_worker_thread();
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<std::shared_ptr<wt9011_session>> ready;
+        bool stopping = false;
+        std::thread thread;
+    };
+
+    void run(Worker& worker);
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::size_t next_ = 0;
+};
+
+// The pool shared by every BLE session in the process
+Dispatcher& dispatcher();
+
+} // namespace wt9011
+
+#endif // WT9011_DISPATCH_H
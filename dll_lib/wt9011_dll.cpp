@@ -5,39 +5,36 @@
 #include <vector>
 #include <stdexcept>
 #include <memory>
+#include "wt9011_types.h"
+#include "wt9011_decoder.h"
+#include "wt9011_batch.h"
+#include "wt9011_commands.h"
+#include "wt9011_log.h"
+#include "wt9011_loop.h"
+#include "wt9011_session.h"
+#include "wt9011_sim.h"
 
 namespace py = pybind11;
 
-// Structure to hold device information
-struct DeviceInfo {
-    std::string name;
-    std::string address;
-};
-
-// Structure to hold sensor data
-struct SensorData {
-    struct Accel { float x, y, z; };
-    struct Gyro { float x, y, z; };
-    struct Angle { float roll, pitch, yaw; };
-    Accel accel;
-    Gyro gyro;
-    Angle angle;
-};
-
 // Global Python interpreter guard
 static std::unique_ptr<py::scoped_interpreter> guard;
 
+// GIL released by the init thread while idle, so the I/O loop thread can run
+static std::unique_ptr<py::gil_scoped_release> gil_release;
+
 // Global Python objects
 static py::object ble_manager_class;
-static py::object ble_manager_instance;
-static py::object parser_class;
-static py::object commands_class;
+static py::object ble_manager_instance; // Used for scanning only
 
-// Callback function pointer type for sensor data
+// Callback function pointer types for sensor data
 using DataCallback = void(*)(const SensorData*);
+using SampleCallback = void(*)(const SensorSample*);
 
-// Global callback for receiving data
-static DataCallback global_callback = nullptr;
+// Session behind the single-device API (wt9011_connect, wt9011_receive, ...)
+static wt9011_session* default_session = nullptr;
+
+// Recorder started by wt9011_record_start
+static wt9011_recorder* default_recorder = nullptr;
 
 // Convert Python dict to SensorData
 SensorData convert_to_sensor_data(py::dict data) {
@@ -54,26 +51,39 @@ SensorData convert_to_sensor_data(py::dict data) {
     return result;
 }
 
-// Run Python coroutine synchronously
+// Decode raw frames (20 bytes each, back to back) into SoA arrays in one pass.
+// Returns the number of frames decoded; stops at the first invalid frame.
+WT9011_API int wt9011_decode_batch(const unsigned char* frames, int count, const SensorDataSoA* out) {
+    if (!frames || !out || count <= 0) {
+        return 0;
+    }
+    return static_cast<int>(wt9011::decode_frames_soa(frames, static_cast<std::size_t>(count), *out));
+}
+
+// Run Python coroutine on the I/O loop thread and wait for its result
 template<typename T>
 T run_coroutine(py::object coro) {
-    py::module_ asyncio = py::module_::import("asyncio");
-    py::object loop = asyncio.attr("get_event_loop")();
-    return loop.attr("run_until_complete")(coro).cast<T>();
+    return wt9011::io_loop().run(coro).cast<T>();
 }
 
 // Initialize Python environment and load modules
-extern "C" __declspec(dllexport) bool wt9011_init() {
+WT9011_API bool wt9011_init() {
     try {
         if (!guard) {
             guard = std::make_unique<py::scoped_interpreter>();
         }
-        py::module_ sys = py::module_::import("sys");
-        sys.attr("path").attr("append")("./lib"); // Add lib directory to Python path
-        ble_manager_class = py::module_::import("ble_manager").attr("BLEManager");]
-        parser_class = py::module_::import("sensor_parser").attr("WT9011Parser");
-        commands_class = py::module_::import("sensor_commands").attr("WT9011Commands");
-        ble_manager_instance = ble_manager_class();
+        {
+            py::gil_scoped_acquire acquire;
+            py::module_ sys = py::module_::import("sys");
+            sys.attr("path").attr("append")("./lib"); // Add lib directory to Python path
+            ble_manager_class = py::module_::import("ble_manager").attr("BLEManager");
+            ble_manager_instance = ble_manager_class();
+            wt9011::set_ble_manager_class(ble_manager_class);
+            wt9011::io_loop().start();
+        }
+        if (!gil_release) {
+            gil_release = std::make_unique<py::gil_scoped_release>();
+        }
         return true;
     } catch (const std::exception& e) {
         return false;
@@ -81,186 +91,253 @@ extern "C" __declspec(dllexport) bool wt9011_init() {
 }
 
 // Scan for BLE devices
-extern "C" __declspec(dllexport) bool wt9011_scan(DeviceInfo* devices, int* count, float timeout) {
+WT9011_API bool wt9011_scan(DeviceInfo* devices, int* count, float timeout) {
+    // Simulated devices (WT9011_SIM) come first and need no radio
+    const int max_count = *count;
+    int found = 0;
+    for (const DeviceInfo& device : wt9011::sim_devices()) {
+        if (found < max_count) {
+            devices[found++] = device;
+        }
+    }
     try {
         if (!ble_manager_instance) {
-            return false;
+            *count = found;
+            return found > 0;
         }
+        py::gil_scoped_acquire acquire;
         auto result = run_coroutine<std::vector<py::dict>>(ble_manager_instance.attr("scan")(timeout));
-        int max_count = *count;
-        *count = std::min(static_cast<int>(result.size()), max_count);
-        for (int i = 0; i < *count; ++i) {
-            devices[i].name = result[i]["name"].cast<std::string>();
-            devices[i].address = result[i]["address"].cast<std::string>();
+        for (size_t i = 0; i < result.size() && found < max_count; ++i, ++found) {
+            devices[found].name = result[i]["name"].cast<std::string>();
+            devices[found].address = result[i]["address"].cast<std::string>();
         }
+        *count = found;
         return true;
     } catch (const std::exception& e) {
-        *count = 0;
-        return false;
+        *count = found;
+        return found > 0;
     }
 }
 
-// Connect to a BLE device
-extern "C" __declspec(dllexport) bool wt9011_connect(const char* address) {
-    try {
-        if (!ble_manager_instance) {
-            return false;
-        }
-        run_coroutine<void>(ble_manager_instance.attr("connect")(address));
-        return true;
-    } catch (const std::exception& e) {
-        return false;
+// Connect to a BLE device; replaces the previous default session
+WT9011_API bool wt9011_connect(const char* address) {
+    if (default_session) {
+        wt9011_close(default_session);
     }
+    default_session = wt9011_open(address);
+    return default_session != nullptr;
 }
 
-// Callback wrapper for Python to call C++ callback
-void data_callback_wrapper(py::bytes data) {
-    if (global_callback) {
-        py::gil_scoped_acquire acquire;
-        auto parsed = parser_class.attr("parse")(data);
-        if (!parsed.is_none()) {
-            SensorData sensor_data = convert_to_sensor_data(parsed);
-            global_callback(&sensor_data);
-        }
+// Adapt the single-device callbacks to the per-session callback signature
+static void default_data_callback(wt9011_session*, const SensorSample* sample, void* user) {
+    reinterpret_cast<DataCallback>(user)(&sample->data);
+}
+
+static void default_sample_callback(wt9011_session*, const SensorSample* sample, void* user) {
+    reinterpret_cast<SampleCallback>(user)(sample);
+}
+
+// Start receiving data. With a null callback samples are queued for wt9011_poll.
+WT9011_API bool wt9011_receive(DataCallback callback) {
+    if (callback) {
+        return wt9011_session_receive(default_session, default_data_callback, reinterpret_cast<void*>(callback));
     }
+    return wt9011_session_receive(default_session, nullptr, nullptr);
 }
 
-// Start receiving data
-extern "C" __declspec(dllexport) bool wt9011_receive(DataCallback callback) {
-    try {
-        if (!ble_manager_instance) {
-            return false;
-        }
-        global_callback = callback;
-        run_coroutine<void>(ble_manager_instance.attr("receive")(py::cpp_function(data_callback_wrapper)));
-        return true;
-    } catch (const std::exception& e) {
-        global_callback = nullptr;
-        return false;
+// Same as wt9011_receive, but the callback also gets the receive timestamp and sequence number
+WT9011_API bool wt9011_receive_samples(SampleCallback callback) {
+    if (callback) {
+        return wt9011_session_receive(default_session, default_sample_callback, reinterpret_cast<void*>(callback));
     }
+    return wt9011_session_receive(default_session, nullptr, nullptr);
+}
+
+// Drain up to `max` queued samples into `out`; returns the number copied.
+// Must only be called from one thread at a time.
+WT9011_API size_t wt9011_poll(SensorData* out, size_t max) {
+    return wt9011_session_poll(default_session, out, max);
+}
+
+// Same as wt9011_poll, with receive timestamps and sequence numbers
+WT9011_API size_t wt9011_poll_samples(SensorSample* out, size_t max) {
+    return wt9011_session_poll_samples(default_session, out, max);
+}
+
+// Samples lost because the poll queue was full
+WT9011_API unsigned long long wt9011_dropped_samples() {
+    return wt9011_session_dropped_samples(default_session);
+}
+
+// Number of stream bytes skipped while resynchronizing on frame headers
+WT9011_API unsigned long long wt9011_discarded_bytes() {
+    return wt9011_session_discarded_bytes(default_session);
 }
 
 // Send a command
-extern "C" __declspec(dllexport) bool wt9011_send(const unsigned char* command, int length) {
-    try {
-        if (!ble_manager_instance) {
-            return false;
-        }
-        std::string command_str(reinterpret_cast<const char*>(command), length);
-        run_coroutine<void>(ble_manager_instance.attr("send")(py::bytes(command_str)));
-        return true;
-    } catch (const std::exception& e) {
-        return false;
-    }
+WT9011_API bool wt9011_send(const unsigned char* command, int length) {
+    return wt9011_session_send(default_session, command, length);
 }
 
 // Disconnect from the device
-extern "C" __declspec(dllexport) bool wt9011_disconnect() {
-    try {
-        if (!ble_manager_instance) {
-            return false;
-        }
-        run_coroutine<void>(ble_manager_instance.attr("disconnect")());
-        global_callback = nullptr;
-        return true;
-    } catch (const std::exception& e) {
+WT9011_API bool wt9011_disconnect() {
+    if (!default_session) {
         return false;
     }
+    bool ok = wt9011_close(default_session);
+    default_session = nullptr;
+    return ok;
 }
 
-// Convert Python bytes to const unsigned char* and length
-bool send_pybytes(py::object py_bytes) {
-    auto str = py_bytes.cast<std::string>();
-    return wt9011_send(reinterpret_cast<const unsigned char*>(str.data()), static_cast<int>(str.size()));
+// Stop recording and finalize the file; false if nothing was recording or a write failed
+WT9011_API bool wt9011_record_stop() {
+    if (!default_recorder) {
+        return false;
+    }
+    bool ok = wt9011_recorder_close(default_recorder);
+    default_recorder = nullptr;
+    return ok;
 }
 
-// Command: Zeroing
-extern "C" __declspec(dllexport) bool wt9011_zeroing() {
-    try {
-        return send_pybytes(commands_class.attr("build_command_zeroing")());
-    } catch (const std::exception& e) {
+// Stream the connected device's samples to a recording file (see wt9011_recorder.h)
+WT9011_API bool wt9011_record_start(const char* path) {
+    wt9011_record_stop();
+    default_recorder = wt9011_recorder_open(path);
+    if (!default_recorder) {
         return false;
     }
+    if (!wt9011_session_record(default_session, default_recorder)) {
+        wt9011_record_stop();
+        return false;
+    }
+    return true;
 }
 
-// Command: Calibration
-extern "C" __declspec(dllexport) bool wt9011_calibration() {
-    try {
-        return send_pybytes(commands_class.attr("build_command_calibration")());
-    } catch (const std::exception& e) {
-        return false;
+// Write the connected device's raw notifications to a capture file
+WT9011_API bool wt9011_capture_start(const char* path) {
+    return path && wt9011_session_capture(default_session, path);
+}
+
+WT9011_API bool wt9011_capture_stop() {
+    return wt9011_session_capture(default_session, nullptr);
+}
+
+// Replace the connected device with playback of a capture file; start it with wt9011_receive
+WT9011_API bool wt9011_replay(const char* path, double speed) {
+    wt9011_record_stop();
+    if (default_session) {
+        wt9011_close(default_session);
     }
+    default_session = wt9011_replay_open(path, speed, false);
+    return default_session != nullptr;
 }
 
-// Command: Save settings
-extern "C" __declspec(dllexport) bool wt9011_save_settings() {
-    try {
-        return send_pybytes(commands_class.attr("build_command_save_settings")());
-    } catch (const std::exception& e) {
-        return false;
+// Start connecting without blocking; completion is reported through the handle
+WT9011_API wt9011_op* wt9011_connect_async(const char* address) {
+    if (default_session) {
+        wt9011_close(default_session);
     }
+    default_session = wt9011_session_create(address);
+    return wt9011_session_connect_async(default_session);
 }
 
-// Command: Factory reset
-extern "C" __declspec(dllexport) bool wt9011_factory_reset() {
-    try {
-        return send_pybytes(commands_class.attr("build_command_factory_reset")());
-    } catch (const std::exception& e) {
-        return false;
+// Queue a command without waiting for the write to complete
+WT9011_API wt9011_op* wt9011_send_async(const unsigned char* command, int length) {
+    return wt9011_session_send_async(default_session, command, length);
+}
+
+// Start disconnecting without blocking; the default session is released right away
+WT9011_API wt9011_op* wt9011_disconnect_async() {
+    if (!default_session) {
+        return nullptr;
     }
+    wt9011_op* op = wt9011_session_disconnect_async(default_session);
+    default_session = nullptr;
+    return op;
+}
+
+// Commands are encoded at compile time (wt9011_commands.h); building them
+// never touches the interpreter
+static bool send_command(const wt9011::Command& command) {
+    return wt9011_send(command.bytes, static_cast<int>(wt9011::kCommandSize));
+}
+
+// Write any register of the WitMotion map
+WT9011_API bool wt9011_write_register(unsigned char reg, unsigned short value) {
+    return send_command(wt9011::encode_command(reg, value));
+}
+
+// Read a register back; replies arrive with the data, so wt9011_receive must be active
+WT9011_API bool wt9011_read_register(unsigned char reg, unsigned short* value, int timeout_ms) {
+    return wt9011_session_read_register(default_session, reg, value, timeout_ms);
+}
+
+// Sliding-window statistics of the connected device (wt9011_session_set_windows)
+WT9011_API bool wt9011_set_windows(const double* seconds, size_t count, double max_rate_hz) {
+    return wt9011_session_set_windows(default_session, seconds, count, max_rate_hz);
+}
+
+WT9011_API bool wt9011_window_stats(size_t window, WindowStats* out) {
+    return wt9011_session_window_stats(default_session, window, out);
+}
+
+// Command: Zeroing
+WT9011_API bool wt9011_zeroing() {
+    return send_command(wt9011::kCommandZeroing);
+}
+
+// Command: Calibration
+WT9011_API bool wt9011_calibration() {
+    return send_command(wt9011::kCommandCalibration);
+}
+
+// Command: Save settings
+WT9011_API bool wt9011_save_settings() {
+    return send_command(wt9011::kCommandSaveSettings);
+}
+
+// Command: Factory reset
+WT9011_API bool wt9011_factory_reset() {
+    return send_command(wt9011::kCommandFactoryReset);
 }
 
 // Command: Sleep
-extern "C" __declspec(dllexport) bool wt9011_sleep() {
-    try {
-        return send_pybytes(commands_class.attr("build_command_sleep")());
-    } catch (const std::exception& e) {
-        return false;
-    }
+WT9011_API bool wt9011_sleep() {
+    return send_command(wt9011::kCommandSleep);
 }
 
 // Command: Wakeup
-extern "C" __declspec(dllexport) bool wt9011_wakeup() {
-    try {
-        return send_pybytes(commands_class.attr("build_command_wakeup")());
-    } catch (const std::exception& e) {
-        return false;
-    }
+WT9011_API bool wt9011_wakeup() {
+    return send_command(wt9011::kCommandWakeup);
 }
 
-// Command: Set return rate
-extern "C" __declspec(dllexport) bool wt9011_set_return_rate(int rate_hz) {
-    try {
-        return send_pybytes(commands_class.attr("build_command_set_return_rate")(rate_hz));
-    } catch (const std::exception& e) {
+// Command: Set return rate (1-100 Hz)
+WT9011_API bool wt9011_set_return_rate(int rate_hz) {
+    if (!wt9011::is_valid_return_rate(rate_hz)) {
         return false;
     }
+    return send_command(wt9011::command_set_return_rate(rate_hz));
 }
 
 // Command: Enable/disable accelerometer
-extern "C" __declspec(dllexport) bool wt9011_accel_enable(bool enable) {
-    try {
-        return send_pybytes(commands_class.attr("build_command_accel_enable")(enable));
-    } catch (const std::exception& e) {
-        return false;
-    }
+WT9011_API bool wt9011_accel_enable(bool enable) {
+    return send_command(wt9011::command_accel_enable(enable));
 }
 
 // Command: Enable/disable gyroscope
-extern "C" __declspec(dllexport) bool wt9011_gyro_enable(bool enable) {
-    try {
-        return send_pybytes(commands_class.attr("build_command_gyro_enable")(enable));
-    } catch (const std::exception& e) {
-        return false;
-    }
+WT9011_API bool wt9011_gyro_enable(bool enable) {
+    return send_command(wt9011::command_gyro_enable(enable));
 }
 
 // Cleanup Python environment
-extern "C" __declspec(dllexport) void wt9011_cleanup() {
+WT9011_API void wt9011_cleanup() {
+    wt9011_record_stop();
+    gil_release.reset(); // Take the GIL back on the init thread
+    wt9011::close_all_sessions();
+    default_session = nullptr;
+    wt9011::io_loop().stop();
     ble_manager_instance = py::object();
     ble_manager_class = py::object();
-    parser_class = py::object();
-    commands_class = py::object();
-    global_callback = nullptr;
     guard.reset();
+    wt9011::log::shutdown();
 }
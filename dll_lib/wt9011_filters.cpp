@@ -0,0 +1,254 @@
+#include "wt9011_filters.h"
+#include <algorithm>
+#include <cmath>
+
+namespace wt9011 {
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+constexpr float kButterworthQ = 0.70710678f;
+
+// 1 for the lanes the stage filters, 0 for the others and the padding
+ChannelBlock channel_mask(unsigned channels) {
+    if (channels == 0) {
+        channels = WT9011_CHANNEL_ALL;
+    }
+    ChannelBlock mask = {};
+    for (std::size_t c = 0; c < kFilterChannels; ++c) {
+        mask.v[c] = (channels >> c) & 1u ? 1.0f : 0.0f;
+    }
+    return mask;
+}
+
+// Transposed direct form II, one coefficient set for every lane
+class BiquadStage : public FilterStage {
+public:
+    BiquadStage(const FilterStageConfig& config, float sample_rate_hz) : mask_(channel_mask(config.channels)) {
+        const float q = config.q > 0.0f ? config.q : kButterworthQ;
+        const float w0 = 2.0f * kPi * config.cutoff_hz / sample_rate_hz;
+        const float cw = std::cos(w0);
+        const float alpha = std::sin(w0) / (2.0f * q);
+        float b0 = 1.0f, b1 = -2.0f * cw, b2 = 1.0f; // Notch
+        switch (config.type) {
+        case WT9011_FILTER_LOWPASS:
+            b0 = b2 = (1.0f - cw) * 0.5f;
+            b1 = 1.0f - cw;
+            break;
+        case WT9011_FILTER_HIGHPASS:
+            b0 = b2 = (1.0f + cw) * 0.5f;
+            b1 = -(1.0f + cw);
+            break;
+        case WT9011_FILTER_BANDPASS:
+            b0 = alpha;
+            b1 = 0.0f;
+            b2 = -alpha;
+            break;
+        default:
+            break;
+        }
+        const float a0 = 1.0f + alpha;
+        b0_ = b0 / a0;
+        b1_ = b1 / a0;
+        b2_ = b2 / a0;
+        a1_ = -2.0f * cw / a0;
+        a2_ = (1.0f - alpha) / a0;
+    }
+
+    bool process(ChannelBlock& x) override {
+        if (!primed_) {
+            // Start from the steady state of the first sample instead of
+            // ringing up from zero
+            const float dc = (b0_ + b1_ + b2_) / (1.0f + a1_ + a2_);
+            for (std::size_t i = 0; i < kFilterLanes; ++i) {
+                const float y = dc * x.v[i];
+                z1_.v[i] = y - b0_ * x.v[i];
+                z2_.v[i] = b2_ * x.v[i] - a2_ * y;
+            }
+            primed_ = true;
+        }
+        for (std::size_t i = 0; i < kFilterLanes; ++i) {
+            const float in = x.v[i];
+            const float y = b0_ * in + z1_.v[i];
+            z1_.v[i] = b1_ * in - a1_ * y + z2_.v[i];
+            z2_.v[i] = b2_ * in - a2_ * y;
+            x.v[i] = in + mask_.v[i] * (y - in);
+        }
+        return true;
+    }
+
+private:
+    const ChannelBlock mask_;
+    float b0_, b1_, b2_, a1_, a2_;
+    ChannelBlock z1_ = {};
+    ChannelBlock z2_ = {};
+    bool primed_ = false;
+};
+
+// Running sum over a ring of past samples; the sum is rebuilt from the ring
+// each time it wraps so rounding errors cannot accumulate
+class MovingAverageStage : public FilterStage {
+public:
+    explicit MovingAverageStage(const FilterStageConfig& config)
+        : mask_(channel_mask(config.channels)), history_(config.length) {}
+
+    bool process(ChannelBlock& x) override {
+        ChannelBlock& oldest = history_[pos_];
+        for (std::size_t i = 0; i < kFilterLanes; ++i) {
+            sum_.v[i] += x.v[i] - oldest.v[i];
+        }
+        oldest = x;
+        filled_ = std::min(filled_ + 1, history_.size());
+        if (++pos_ == history_.size()) {
+            pos_ = 0;
+            sum_ = {};
+            for (const ChannelBlock& past : history_) {
+                for (std::size_t i = 0; i < kFilterLanes; ++i) {
+                    sum_.v[i] += past.v[i];
+                }
+            }
+        }
+        const float scale = 1.0f / static_cast<float>(filled_);
+        for (std::size_t i = 0; i < kFilterLanes; ++i) {
+            x.v[i] += mask_.v[i] * (sum_.v[i] * scale - x.v[i]);
+        }
+        return true;
+    }
+
+private:
+    const ChannelBlock mask_;
+    std::vector<ChannelBlock> history_;
+    ChannelBlock sum_ = {};
+    std::size_t pos_ = 0;
+    std::size_t filled_ = 0;
+};
+
+// Per-channel windows, selected with nth_element on a stack copy
+class MedianStage : public FilterStage {
+public:
+    explicit MedianStage(const FilterStageConfig& config)
+        : channels_(config.channels ? config.channels : static_cast<unsigned>(WT9011_CHANNEL_ALL)),
+          window_(config.length), history_(kFilterChannels * config.length) {}
+
+    bool process(ChannelBlock& x) override {
+        filled_ = std::min(filled_ + 1, window_);
+        float scratch[kMaxMedianWindow];
+        for (std::size_t c = 0; c < kFilterChannels; ++c) {
+            if (!((channels_ >> c) & 1u)) {
+                continue;
+            }
+            float* window = history_.data() + c * window_;
+            window[pos_] = x.v[c];
+            std::copy(window, window + filled_, scratch);
+            float* middle = scratch + filled_ / 2;
+            std::nth_element(scratch, middle, scratch + filled_);
+            x.v[c] = *middle;
+        }
+        pos_ = pos_ + 1 == window_ ? 0 : pos_ + 1;
+        return true;
+    }
+
+private:
+    const unsigned channels_;
+    const std::size_t window_;
+    std::vector<float> history_;
+    std::size_t pos_ = 0;
+    std::size_t filled_ = 0;
+};
+
+// Keeps the first of every `factor` samples; put a low-pass before it
+class DecimateStage : public FilterStage {
+public:
+    explicit DecimateStage(unsigned factor) : factor_(factor) {}
+
+    bool process(ChannelBlock&) override {
+        const bool keep = phase_ == 0;
+        phase_ = phase_ + 1 == factor_ ? 0 : phase_ + 1;
+        return keep;
+    }
+
+private:
+    const unsigned factor_;
+    unsigned phase_ = 0;
+};
+
+bool valid_stage(const FilterStageConfig& config, float sample_rate_hz) {
+    if (config.channels & ~static_cast<unsigned>(WT9011_CHANNEL_ALL)) {
+        return false;
+    }
+    switch (config.type) {
+    case WT9011_FILTER_LOWPASS:
+    case WT9011_FILTER_HIGHPASS:
+    case WT9011_FILTER_BANDPASS:
+    case WT9011_FILTER_NOTCH:
+        return sample_rate_hz > 0.0f && config.cutoff_hz > 0.0f && config.cutoff_hz < sample_rate_hz * 0.5f;
+    case WT9011_FILTER_MOVING_AVERAGE:
+    case WT9011_FILTER_DECIMATE:
+        return config.length >= 1 && config.length <= kMaxFilterWindow;
+    case WT9011_FILTER_MEDIAN:
+        return config.length >= 1 && config.length <= kMaxMedianWindow;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+void to_channels(const SensorData& data, ChannelBlock& out) {
+    out.v[0] = data.accel.x;
+    out.v[1] = data.accel.y;
+    out.v[2] = data.accel.z;
+    out.v[3] = data.gyro.x;
+    out.v[4] = data.gyro.y;
+    out.v[5] = data.gyro.z;
+    out.v[6] = data.angle.roll;
+    out.v[7] = data.angle.pitch;
+    out.v[8] = data.angle.yaw;
+    out.v[9] = out.v[10] = out.v[11] = 0.0f;
+}
+
+void from_channels(const ChannelBlock& in, SensorData& data) {
+    data.accel = { in.v[0], in.v[1], in.v[2] };
+    data.gyro = { in.v[3], in.v[4], in.v[5] };
+    data.angle = { in.v[6], in.v[7], in.v[8] };
+}
+
+std::unique_ptr<FilterChain> FilterChain::create(const FilterStageConfig* stages, std::size_t count,
+                                                 float sample_rate_hz) {
+    auto chain = std::make_unique<FilterChain>();
+    for (std::size_t i = 0; i < count; ++i) {
+        const FilterStageConfig& config = stages[i];
+        if (!valid_stage(config, sample_rate_hz)) {
+            return nullptr;
+        }
+        switch (config.type) {
+        case WT9011_FILTER_MOVING_AVERAGE:
+            chain->stages_.push_back(std::make_unique<MovingAverageStage>(config));
+            break;
+        case WT9011_FILTER_MEDIAN:
+            chain->stages_.push_back(std::make_unique<MedianStage>(config));
+            break;
+        case WT9011_FILTER_DECIMATE:
+            chain->stages_.push_back(std::make_unique<DecimateStage>(config.length));
+            break;
+        default:
+            chain->stages_.push_back(std::make_unique<BiquadStage>(config, sample_rate_hz));
+            break;
+        }
+    }
+    return chain;
+}
+
+bool FilterChain::process(SensorData& data) {
+    ChannelBlock x;
+    to_channels(data, x);
+    for (auto& stage : stages_) {
+        if (!stage->process(x)) {
+            return false;
+        }
+    }
+    from_channels(x, data);
+    return true;
+}
+
+} // namespace wt9011
@@ -0,0 +1,52 @@
+#ifndef WT9011_FILTERS_H
+#define WT9011_FILTERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "wt9011_types.h"
+
+namespace wt9011 {
+
+// The nine SensorData channels, padded so every per-channel array is a whole
+// number of SIMD registers; stages run branch-free across all lanes
+constexpr std::size_t kFilterChannels = 9;
+constexpr std::size_t kFilterLanes = 12;
+constexpr unsigned kMaxMedianWindow = 255;
+constexpr unsigned kMaxFilterWindow = 65536;
+
+struct alignas(16) ChannelBlock {
+    float v[kFilterLanes];
+};
+
+void to_channels(const SensorData& data, ChannelBlock& out);
+void from_channels(const ChannelBlock& in, SensorData& data);
+
+class FilterStage {
+public:
+    virtual ~FilterStage() = default;
+    // Filter `x` in place; false drops the sample (decimation)
+    virtual bool process(ChannelBlock& x) = 0;
+};
+
+// Stages of one session, applied in order to every decoded sample before the
+// recorder, fusion, callback and poll queue see it. All state is allocated
+// up front; processing never allocates. Angles are filtered as plain numbers,
+// so leave yaw out (WT9011_CHANNEL_*) when it wraps at ±180°.
+class FilterChain {
+public:
+    // Null on an invalid stage (cutoff outside 0 .. rate / 2, zero length, ...)
+    static std::unique_ptr<FilterChain> create(const FilterStageConfig* stages, std::size_t count,
+                                               float sample_rate_hz);
+
+    // False if a stage dropped the sample
+    bool process(SensorData& data);
+
+private:
+    std::vector<std::unique_ptr<FilterStage>> stages_;
+};
+
+} // namespace wt9011
+
+#endif // WT9011_FILTERS_H
@@ -0,0 +1,317 @@
+#include "wt9011_fusion.h"
+#include <algorithm>
+#include <cmath>
+#include "wt9011_batch.h"
+
+namespace wt9011 {
+
+namespace {
+
+constexpr float kDegToRad = 3.14159265358979323846f / 180.0f;
+// Lanes gathered per kernel call; the inputs stay on the stack
+constexpr std::size_t kFusionBlock = 32;
+
+// The filters are written once against these helpers and instantiated for
+// one lane (float) and, with SSE2, four lanes (F4)
+inline float splat(float x, float) { return x; }
+inline float load(const float* p, float) { return *p; }
+inline void store(float* p, float v) { *p = v; }
+inline float vsqrt(float x) { return std::sqrt(x); }
+inline float positive(float x) { return x > 0.0f ? 1.0f : 0.0f; }
+
+#if defined(WT9011_HAVE_SSE2)
+
+struct F4 {
+    __m128 v;
+};
+
+inline F4 operator+(F4 a, F4 b) { return { _mm_add_ps(a.v, b.v) }; }
+inline F4 operator-(F4 a, F4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline F4 operator*(F4 a, F4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline F4 operator/(F4 a, F4 b) { return { _mm_div_ps(a.v, b.v) }; }
+inline F4 operator-(F4 a) { return { _mm_sub_ps(_mm_setzero_ps(), a.v) }; }
+inline F4 operator*(float a, F4 b) { return { _mm_mul_ps(_mm_set1_ps(a), b.v) }; }
+inline F4 operator+(F4 a, float b) { return { _mm_add_ps(a.v, _mm_set1_ps(b)) }; }
+inline F4 operator-(F4 a, float b) { return { _mm_sub_ps(a.v, _mm_set1_ps(b)) }; }
+inline F4 operator-(float a, F4 b) { return { _mm_sub_ps(_mm_set1_ps(a), b.v) }; }
+inline F4 operator/(float a, F4 b) { return { _mm_div_ps(_mm_set1_ps(a), b.v) }; }
+inline F4& operator+=(F4& a, F4 b) { return a = a + b; }
+inline F4& operator-=(F4& a, F4 b) { return a = a - b; }
+inline F4& operator*=(F4& a, F4 b) { return a = a * b; }
+inline F4 splat(float x, F4) { return { _mm_set1_ps(x) }; }
+inline F4 load(const float* p, F4) { return { _mm_loadu_ps(p) }; }
+inline void store(float* p, F4 v) { _mm_storeu_ps(p, v.v); }
+inline F4 vsqrt(F4 x) { return { _mm_sqrt_ps(x.v) }; }
+inline F4 positive(F4 x) { return { _mm_and_ps(_mm_cmpgt_ps(x.v, _mm_setzero_ps()), _mm_set1_ps(1.0f)) }; }
+
+#endif
+
+// 1 / |v|, or 0 for a zero vector
+template <typename V>
+V inverse_norm(V x, V y, V z) {
+    const V n2 = x * x + y * y + z * z;
+    const V valid = positive(n2);
+    return valid / vsqrt(n2 + (1.0f - valid));
+}
+
+template <typename V>
+void normalize(V& w, V& x, V& y, V& z) {
+    const V n2 = w * w + x * x + y * y + z * z;
+    const V inv = 1.0f / vsqrt(n2);
+    w *= inv;
+    x *= inv;
+    y *= inv;
+    z *= inv;
+}
+
+// Inputs of one block, gyro already in rad/s
+struct FusionInputs {
+    float ax[kFusionBlock], ay[kFusionBlock], az[kFusionBlock];
+    float gx[kFusionBlock], gy[kFusionBlock], gz[kFusionBlock];
+    float dt[kFusionBlock];
+};
+
+// Madgwick's IMU update: gyro integration plus a gradient-descent step
+// towards the orientation that explains the measured gravity
+template <typename V>
+void madgwick_lanes(const FusionInputs& in, std::size_t i, float* qw_p, float* qx_p, float* qy_p, float* qz_p,
+                    float beta_value) {
+    const V tag{};
+    V q0 = load(qw_p, tag), q1 = load(qx_p, tag), q2 = load(qy_p, tag), q3 = load(qz_p, tag);
+    V ax = load(in.ax + i, tag), ay = load(in.ay + i, tag), az = load(in.az + i, tag);
+    const V gx = load(in.gx + i, tag), gy = load(in.gy + i, tag), gz = load(in.gz + i, tag);
+    const V dt = load(in.dt + i, tag);
+    const V beta = splat(beta_value, tag);
+
+    V d0 = 0.5f * (-(q1 * gx) - q2 * gy - q3 * gz);
+    V d1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    V d2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    V d3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    // A zero accel vector (sensor disabled) leaves the gradient at zero
+    const V inv_a = inverse_norm(ax, ay, az);
+    ax *= inv_a;
+    ay *= inv_a;
+    az *= inv_a;
+    const V valid = positive(inv_a);
+
+    const V q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+    V s0 = 4.0f * q0 * q2q2 + 2.0f * q2 * ax + 4.0f * q0 * q1q1 - 2.0f * q1 * ay;
+    V s1 = 4.0f * q1 * q3q3 - 2.0f * q3 * ax + 4.0f * q0q0 * q1 - 2.0f * q0 * ay - 4.0f * q1 + 8.0f * q1 * q1q1 +
+           8.0f * q1 * q2q2 + 4.0f * q1 * az;
+    V s2 = 4.0f * q0q0 * q2 + 2.0f * q0 * ax + 4.0f * q2 * q3q3 - 2.0f * q3 * ay - 4.0f * q2 + 8.0f * q2 * q1q1 +
+           8.0f * q2 * q2q2 + 4.0f * q2 * az;
+    V s3 = 4.0f * q1q1 * q3 - 2.0f * q1 * ax + 4.0f * q2q2 * q3 - 2.0f * q2 * ay;
+    const V n2 = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+    const V has_step = positive(n2);
+    const V inv_s = beta * valid * has_step / vsqrt(n2 + (1.0f - has_step));
+
+    q0 += (d0 - s0 * inv_s) * dt;
+    q1 += (d1 - s1 * inv_s) * dt;
+    q2 += (d2 - s2 * inv_s) * dt;
+    q3 += (d3 - s3 * inv_s) * dt;
+    normalize(q0, q1, q2, q3);
+    store(qw_p, q0);
+    store(qx_p, q1);
+    store(qy_p, q2);
+    store(qz_p, q3);
+}
+
+// Mahony's complementary filter: the cross product between measured and
+// estimated gravity feeds back into the gyro through a PI controller
+template <typename V>
+void mahony_lanes(const FusionInputs& in, std::size_t i, float* qw_p, float* qx_p, float* qy_p, float* qz_p,
+                  float* bx_p, float* by_p, float* bz_p, float kp, float ki) {
+    const V tag{};
+    V q0 = load(qw_p, tag), q1 = load(qx_p, tag), q2 = load(qy_p, tag), q3 = load(qz_p, tag);
+    V ax = load(in.ax + i, tag), ay = load(in.ay + i, tag), az = load(in.az + i, tag);
+    V gx = load(in.gx + i, tag), gy = load(in.gy + i, tag), gz = load(in.gz + i, tag);
+    V bx = load(bx_p, tag), by = load(by_p, tag), bz = load(bz_p, tag);
+    const V dt = load(in.dt + i, tag);
+
+    const V inv_a = inverse_norm(ax, ay, az);
+    ax *= inv_a;
+    ay *= inv_a;
+    az *= inv_a;
+
+    // Half of the gravity direction the current estimate predicts
+    const V vx = q1 * q3 - q0 * q2;
+    const V vy = q0 * q1 + q2 * q3;
+    const V vz = q0 * q0 - 0.5f + q3 * q3;
+    const V ex = ay * vz - az * vy;
+    const V ey = az * vx - ax * vz;
+    const V ez = ax * vy - ay * vx;
+
+    const V two_ki_dt = (2.0f * ki) * dt;
+    bx += two_ki_dt * ex;
+    by += two_ki_dt * ey;
+    bz += two_ki_dt * ez;
+    const V two_kp = splat(2.0f * kp, tag);
+    gx += bx + two_kp * ex;
+    gy += by + two_kp * ey;
+    gz += bz + two_kp * ez;
+
+    const V half_dt = 0.5f * dt;
+    gx *= half_dt;
+    gy *= half_dt;
+    gz *= half_dt;
+    const V a = q0, b = q1, c = q2;
+    q0 += -(b * gx) - c * gy - q3 * gz;
+    q1 += a * gx + c * gz - q3 * gy;
+    q2 += a * gy - b * gz + q3 * gx;
+    q3 += a * gz + b * gy - c * gx;
+    normalize(q0, q1, q2, q3);
+    store(qw_p, q0);
+    store(qx_p, q1);
+    store(qy_p, q2);
+    store(qz_p, q3);
+    store(bx_p, bx);
+    store(by_p, by);
+    store(bz_p, bz);
+}
+
+} // namespace
+
+FusionBank::FusionBank(const FusionConfig& config, std::size_t lanes)
+    : config_(config), lanes_(lanes), qw_(lanes), qx_(lanes), qy_(lanes), qz_(lanes), bias_x_(lanes),
+      bias_y_(lanes), bias_z_(lanes), last_ns_(lanes), started_(lanes) {
+    if (config_.gain <= 0.0f) {
+        config_.gain = config_.algorithm == WT9011_FUSION_MAHONY ? kDefaultMahonyKp : kDefaultMadgwickBeta;
+    }
+    config_.integral_gain = std::max(config_.integral_gain, 0.0f);
+    reset();
+}
+
+void FusionBank::reset() {
+    std::fill(qw_.begin(), qw_.end(), 1.0f);
+    std::fill(qx_.begin(), qx_.end(), 0.0f);
+    std::fill(qy_.begin(), qy_.end(), 0.0f);
+    std::fill(qz_.begin(), qz_.end(), 0.0f);
+    std::fill(bias_x_.begin(), bias_x_.end(), 0.0f);
+    std::fill(bias_y_.begin(), bias_y_.end(), 0.0f);
+    std::fill(bias_z_.begin(), bias_z_.end(), 0.0f);
+    std::fill(started_.begin(), started_.end(), 0);
+}
+
+void FusionBank::update(std::size_t first, const SensorSample* samples, std::size_t count, FusedSample* out) {
+    if (first >= lanes_) {
+        return;
+    }
+    count = std::min(count, lanes_ - first);
+    const float fixed_step = config_.sample_rate_hz > 0.0f ? 1.0f / config_.sample_rate_hz : 0.0f;
+    FusionInputs in;
+    for (std::size_t base = 0; base < count; base += kFusionBlock) {
+        const std::size_t n = std::min(kFusionBlock, count - base);
+        for (std::size_t j = 0; j < n; ++j) {
+            const SensorData& d = samples[base + j].data;
+            const std::size_t lane = first + base + j;
+            in.ax[j] = d.accel.x;
+            in.ay[j] = d.accel.y;
+            in.az[j] = d.accel.z;
+            in.gx[j] = d.gyro.x * kDegToRad;
+            in.gy[j] = d.gyro.y * kDegToRad;
+            in.gz[j] = d.gyro.z * kDegToRad;
+            const std::uint64_t now = samples[base + j].timestamp_ns;
+            if (!started_[lane]) {
+                // Tilt straight from gravity; yaw starts at zero
+                const float roll = std::atan2(d.accel.y, d.accel.z);
+                const float pitch = std::atan2(-d.accel.x, std::sqrt(d.accel.y * d.accel.y + d.accel.z * d.accel.z));
+                const float cr = std::cos(roll * 0.5f), sr = std::sin(roll * 0.5f);
+                const float cp = std::cos(pitch * 0.5f), sp = std::sin(pitch * 0.5f);
+                qw_[lane] = cr * cp;
+                qx_[lane] = sr * cp;
+                qy_[lane] = cr * sp;
+                qz_[lane] = -sr * sp;
+                started_[lane] = 1;
+                in.dt[j] = 0.0f;
+            } else if (fixed_step > 0.0f) {
+                in.dt[j] = fixed_step;
+            } else {
+                const float step = now > last_ns_[lane] ? static_cast<float>(now - last_ns_[lane]) * 1e-9f : 0.0f;
+                in.dt[j] = std::min(step, kMaxFusionStep);
+            }
+            last_ns_[lane] = now;
+        }
+
+        const std::size_t lane0 = first + base;
+        float* qw = qw_.data() + lane0;
+        float* qx = qx_.data() + lane0;
+        float* qy = qy_.data() + lane0;
+        float* qz = qz_.data() + lane0;
+        std::size_t j = 0;
+        if (config_.algorithm == WT9011_FUSION_MAHONY) {
+            float* bx = bias_x_.data() + lane0;
+            float* by = bias_y_.data() + lane0;
+            float* bz = bias_z_.data() + lane0;
+#if defined(WT9011_HAVE_SSE2)
+            for (; j + 4 <= n; j += 4) {
+                mahony_lanes<F4>(in, j, qw + j, qx + j, qy + j, qz + j, bx + j, by + j, bz + j, config_.gain,
+                                 config_.integral_gain);
+            }
+#endif
+            for (; j < n; ++j) {
+                mahony_lanes<float>(in, j, qw + j, qx + j, qy + j, qz + j, bx + j, by + j, bz + j, config_.gain,
+                                    config_.integral_gain);
+            }
+        } else {
+#if defined(WT9011_HAVE_SSE2)
+            for (; j + 4 <= n; j += 4) {
+                madgwick_lanes<F4>(in, j, qw + j, qx + j, qy + j, qz + j, config_.gain);
+            }
+#endif
+            for (; j < n; ++j) {
+                madgwick_lanes<float>(in, j, qw + j, qx + j, qy + j, qz + j, config_.gain);
+            }
+        }
+
+        if (!out) {
+            continue;
+        }
+        for (j = 0; j < n; ++j) {
+            FusedSample& o = out[base + j];
+            const float w = qw[j], x = qx[j], y = qy[j], z = qz[j];
+            o.sample = samples[base + j];
+            o.quaternion[0] = w;
+            o.quaternion[1] = x;
+            o.quaternion[2] = y;
+            o.quaternion[3] = z;
+            // Gravity (1 g along earth z) seen from the sensor frame
+            o.linear_accel[0] = in.ax[j] - 2.0f * (x * z - w * y);
+            o.linear_accel[1] = in.ay[j] - 2.0f * (w * x + y * z);
+            o.linear_accel[2] = in.az[j] - (w * w - x * x - y * y + z * z);
+        }
+    }
+}
+
+} // namespace wt9011
+
+WT9011_API wt9011_fusion* wt9011_fusion_create(const FusionConfig* config, size_t lanes) {
+    if (!config || lanes == 0) {
+        return nullptr;
+    }
+    try {
+        return new wt9011_fusion(*config, lanes);
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+WT9011_API size_t wt9011_fusion_update(wt9011_fusion* fusion, const SensorSample* samples, size_t count,
+                                       FusedSample* out) {
+    if (!fusion || !samples) {
+        return 0;
+    }
+    count = std::min(count, fusion->bank.lanes());
+    fusion->bank.update(0, samples, count, out);
+    return count;
+}
+
+WT9011_API void wt9011_fusion_reset(wt9011_fusion* fusion) {
+    if (fusion) {
+        fusion->bank.reset();
+    }
+}
+
+WT9011_API void wt9011_fusion_free(wt9011_fusion* fusion) {
+    delete fusion;
+}
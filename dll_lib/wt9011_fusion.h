@@ -0,0 +1,58 @@
+#ifndef WT9011_FUSION_H
+#define WT9011_FUSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "wt9011_api.h"
+#include "wt9011_types.h"
+
+namespace wt9011 {
+
+constexpr float kDefaultMadgwickBeta = 0.1f;
+constexpr float kDefaultMahonyKp = 0.5f;
+// Longest step taken from timestamps; a gap after a lost link is not integrated
+constexpr float kMaxFusionStep = 0.1f;
+
+// Madgwick or Mahony AHRS filters (accel + gyro, no magnetometer) for a number
+// of sensors ("lanes"). State is kept as structure of arrays and one update
+// advances four lanes per SSE2 instruction, so a single core fuses dozens of
+// sensors at full rate. Each lane's first sample sets its tilt from gravity.
+class FusionBank {
+public:
+    FusionBank(const FusionConfig& config, std::size_t lanes);
+
+    std::size_t lanes() const { return lanes_; }
+    void reset();
+    // Advance lanes first .. first + count - 1 with samples[0 .. count - 1]
+    void update(std::size_t first, const SensorSample* samples, std::size_t count, FusedSample* out);
+
+private:
+    FusionConfig config_;
+    std::size_t lanes_;
+    std::vector<float> qw_, qx_, qy_, qz_;
+    std::vector<float> bias_x_, bias_y_, bias_z_; // Mahony integral feedback
+    std::vector<std::uint64_t> last_ns_;
+    std::vector<unsigned char> started_;
+};
+
+// Fusion stage of one session: runs after the decoder, before the callbacks
+struct FusionStage {
+    FusionStage(const FusionConfig& config, SessionFusedCallback callback, void* user)
+        : bank(config, 1), callback(callback), user(user) {}
+
+    FusionBank bank; // Delivering thread only
+    SessionFusedCallback callback;
+    void* user;
+};
+
+} // namespace wt9011
+
+struct wt9011_fusion {
+    explicit wt9011_fusion(const FusionConfig& config, std::size_t lanes) : bank(config, lanes) {}
+
+    wt9011::FusionBank bank;
+};
+
+#endif // WT9011_FUSION_H
@@ -0,0 +1,350 @@
+#include "wt9011_log.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "wt9011_api.h"
+#include "wt9011_capture.h"
+#include "wt9011_clock.h"
+
+namespace wt9011 {
+namespace log {
+
+std::atomic<int> runtime_level{WT9011_LOG_LEVEL_INFO};
+std::atomic<bool> packet_trace{false};
+
+namespace {
+
+enum RecordKind : std::uint8_t { kMessage, kPacket };
+
+struct Record {
+    // Vyukov bounded queue: a slot is free for position p when sequence == p
+    // and holds a published record when sequence == p + 1
+    std::atomic<std::uint64_t> sequence;
+    std::uint64_t timestamp_ns;
+    std::uint16_t length;
+    std::uint8_t kind;
+    std::uint8_t level;
+    char payload[kRecordPayload];
+};
+
+const char* level_name(int level) {
+    switch (level) {
+        case WT9011_LOG_LEVEL_TRACE: return "TRACE";
+        case WT9011_LOG_LEVEL_DEBUG: return "DEBUG";
+        case WT9011_LOG_LEVEL_INFO: return "INFO";
+        case WT9011_LOG_LEVEL_WARN: return "WARNING";
+        default: return "ERROR";
+    }
+}
+
+// Multi-producer, single-consumer. Producers only claim a slot with a CAS and
+// copy into it; formatting to text and all I/O happen on the writer thread.
+class Logger {
+public:
+    Logger() : origin_ns_(monotonic_ns()) {
+        for (std::size_t i = 0; i < kRecordSlots; ++i) {
+            records_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    Record* claim() {
+        ensure_running();
+        std::uint64_t position = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Record& record = records_[position % kRecordSlots];
+            const std::uint64_t sequence = record.sequence.load(std::memory_order_acquire);
+            const std::int64_t diff = static_cast<std::int64_t>(sequence - position);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    return &record;
+                }
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            } else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish(Record* record, bool urgent) {
+        const std::uint64_t position = record->sequence.load(std::memory_order_relaxed);
+        record->sequence.store(position + 1, std::memory_order_release);
+        if (urgent) {
+            wake_.notify_one();
+        }
+    }
+
+    bool open(const char* path) {
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        std::FILE* file = nullptr;
+        if (path && *path) {
+            file = std::fopen(path, "a");
+            if (!file) {
+                return false;
+            }
+        }
+        if (log_file_) {
+            std::fclose(log_file_);
+        }
+        log_file_ = file;
+        return true;
+    }
+
+    bool trace_packets(const char* path) {
+        if (!path || !*path) {
+            packet_trace.store(false, std::memory_order_relaxed);
+            // Let queued packets reach the file before it is closed
+            drain_now();
+            std::lock_guard<std::mutex> lock(sink_mutex_);
+            if (trace_) {
+                trace_->close();
+                trace_.reset();
+            }
+            return true;
+        }
+        std::unique_ptr<CaptureWriter> trace(new CaptureWriter());
+        if (!trace->open(path)) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sink_mutex_);
+            if (trace_) {
+                trace_->close();
+            }
+            trace_ = std::move(trace);
+        }
+        ensure_running();
+        packet_trace.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    void stop() {
+        std::lock_guard<std::mutex> lock(thread_mutex_);
+        if (!thread_.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> wake_lock(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+        stopping_ = false;
+        running_.store(false, std::memory_order_release);
+        drain_now(); // Whatever raced in after the last pass
+    }
+
+    void close_files() {
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        close_files_locked();
+    }
+
+    // Static destruction without wt9011_cleanup. On Windows this runs under
+    // the loader lock, where joining the writer deadlocks, and at process
+    // exit the writer may already have been killed holding a lock. So only
+    // ask it to stop and flush what is queued if nothing blocks; the Logger
+    // itself is never freed, so a writer still running stays safe.
+    void abandon() {
+        {
+            std::unique_lock<std::mutex> wake_lock(wake_mutex_, std::try_to_lock);
+            if (wake_lock) {
+                stopping_ = true;
+            }
+        }
+        wake_.notify_one();
+        std::unique_lock<std::mutex> drain(drain_mutex_, std::try_to_lock);
+        std::unique_lock<std::mutex> lock(sink_mutex_, std::try_to_lock);
+        if (drain && lock) {
+            drain_locked();
+            close_files_locked();
+        }
+    }
+
+private:
+    void close_files_locked() {
+        if (log_file_) {
+            std::fclose(log_file_);
+            log_file_ = nullptr;
+        }
+        if (trace_) {
+            trace_->close();
+            trace_.reset();
+        }
+    }
+
+    void ensure_running() {
+        if (running_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(thread_mutex_);
+        if (!thread_.joinable()) {
+            thread_ = std::thread([this]() { run(); });
+            running_.store(true, std::memory_order_release);
+        }
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        while (!stopping_) {
+            lock.unlock();
+            drain_now();
+            lock.lock();
+            // Routine records are picked up on the next tick, so producers
+            // never pay for a wakeup; warnings and errors wake us at once
+            wake_.wait_for(lock, std::chrono::milliseconds(20));
+        }
+        lock.unlock();
+        drain_now();
+    }
+
+    // Only one thread drains at a time (the writer, or a caller that has
+    // stopped it / needs the trace flushed)
+    void drain_now() {
+        std::lock_guard<std::mutex> drain(drain_mutex_);
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        drain_locked();
+    }
+
+    void drain_locked() {
+        std::FILE* out = log_file_ ? log_file_ : stderr;
+        bool wrote_text = false;
+        for (;;) {
+            Record& record = records_[tail_ % kRecordSlots];
+            if (record.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+                break;
+            }
+            if (record.kind == kPacket) {
+                if (trace_) {
+                    trace_->append(record.timestamp_ns, reinterpret_cast<const std::uint8_t*>(record.payload),
+                                   record.length);
+                }
+            } else {
+                const double seconds = static_cast<double>(record.timestamp_ns - origin_ns_) / 1e9;
+                std::fprintf(out, "%10.6f [%s] %.*s\n", seconds, level_name(record.level),
+                             static_cast<int>(record.length), record.payload);
+                wrote_text = true;
+            }
+            record.sequence.store(tail_ + kRecordSlots, std::memory_order_release);
+            ++tail_;
+        }
+        if (wrote_text) {
+            std::fflush(out);
+        }
+    }
+
+    Record records_[kRecordSlots];
+    std::atomic<std::uint64_t> head_{0};
+    std::uint64_t tail_ = 0; // Guarded by drain_mutex_
+    std::atomic<std::uint64_t> dropped_{0};
+    const std::uint64_t origin_ns_;
+
+    std::mutex drain_mutex_;
+    std::mutex sink_mutex_;
+    std::FILE* log_file_ = nullptr;
+    std::unique_ptr<CaptureWriter> trace_;
+
+    std::mutex thread_mutex_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
+
+struct ExitFlush {
+    Logger* logger;
+    ~ExitFlush() { logger->abandon(); }
+};
+
+// Never destroyed: the writer thread may outlive static destruction, and
+// wt9011_log::shutdown() from wt9011_cleanup is the orderly way to stop it
+Logger& logger() {
+    static Logger* instance = new Logger();
+    static ExitFlush flush{instance};
+    return *instance;
+}
+
+} // namespace
+
+void write(int level, const char* format, ...) {
+    Logger& log = logger();
+    Record* record = log.claim();
+    if (!record) {
+        return;
+    }
+    record->timestamp_ns = monotonic_ns();
+    record->kind = kMessage;
+    record->level = static_cast<std::uint8_t>(level);
+    va_list args;
+    va_start(args, format);
+    const int written = std::vsnprintf(record->payload, kRecordPayload, format, args);
+    va_end(args);
+    std::size_t length = written < 0 ? 0 : static_cast<std::size_t>(written);
+    record->length = static_cast<std::uint16_t>(length < kRecordPayload ? length : kRecordPayload - 1);
+    log.publish(record, level >= WT9011_LOG_LEVEL_WARN);
+}
+
+void trace_packet(std::uint64_t timestamp_ns, const std::uint8_t* data, std::size_t length) {
+    Logger& log = logger();
+    Record* record = log.claim();
+    if (!record) {
+        return;
+    }
+    const std::size_t kept = length < kRecordPayload ? length : kRecordPayload;
+    record->timestamp_ns = timestamp_ns;
+    record->kind = kPacket;
+    record->level = WT9011_LOG_LEVEL_TRACE;
+    record->length = static_cast<std::uint16_t>(kept);
+    std::memcpy(record->payload, data, kept);
+    log.publish(record, false);
+}
+
+void set_level(int level) {
+    runtime_level.store(level, std::memory_order_relaxed);
+}
+
+bool open(const char* path) {
+    return logger().open(path);
+}
+
+bool trace_packets(const char* path) {
+    return logger().trace_packets(path);
+}
+
+std::uint64_t dropped() {
+    return logger().dropped();
+}
+
+void shutdown() {
+    packet_trace.store(false, std::memory_order_relaxed);
+    Logger& log = logger();
+    log.stop();
+    log.close_files();
+}
+
+} // namespace log
+} // namespace wt9011
+
+WT9011_API void wt9011_log_set_level(int level) {
+    wt9011::log::set_level(level);
+}
+
+WT9011_API bool wt9011_log_open(const char* path) {
+    return wt9011::log::open(path);
+}
+
+WT9011_API bool wt9011_log_trace_packets(const char* path) {
+    return wt9011::log::trace_packets(path);
+}
+
+WT9011_API unsigned long long wt9011_log_dropped() {
+    return wt9011::log::dropped();
+}
@@ -0,0 +1,129 @@
+#ifndef WT9011_LOG_H
+#define WT9011_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Log levels. Messages below WT9011_LOG_LEVEL are removed by the
+// preprocessor, arguments included; the rest are filtered at runtime by
+// wt9011_log_set_level (default: info).
+#define WT9011_LOG_LEVEL_TRACE 0
+#define WT9011_LOG_LEVEL_DEBUG 1
+#define WT9011_LOG_LEVEL_INFO 2
+#define WT9011_LOG_LEVEL_WARN 3
+#define WT9011_LOG_LEVEL_ERROR 4
+#define WT9011_LOG_LEVEL_OFF 5
+
+#ifndef WT9011_LOG_LEVEL
+#ifdef NDEBUG
+#define WT9011_LOG_LEVEL WT9011_LOG_LEVEL_INFO
+#else
+#define WT9011_LOG_LEVEL WT9011_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+// Raw packet trace: one relaxed load per notification while switched off.
+// Define as 0 to compile the hook out entirely.
+#ifndef WT9011_LOG_PACKETS
+#define WT9011_LOG_PACKETS 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WT9011_PRINTF_FORMAT(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+#define WT9011_PRINTF_FORMAT(fmt, args)
+#endif
+
+namespace wt9011 {
+namespace log {
+
+// Longest message or packet kept per record; longer ones are truncated.
+// 244 bytes is the largest notification a BLE 4.2+ link can carry.
+constexpr std::size_t kRecordPayload = 244;
+constexpr std::size_t kRecordSlots = 4096;
+
+extern std::atomic<int> runtime_level;
+extern std::atomic<bool> packet_trace;
+
+inline bool enabled(int level) {
+    return level >= runtime_level.load(std::memory_order_relaxed);
+}
+
+inline bool packet_trace_enabled() {
+    return packet_trace.load(std::memory_order_relaxed);
+}
+
+// Formats into the ring and returns; the writer thread does the I/O.
+// Records that do not fit in the ring are dropped and counted.
+void write(int level, const char* format, ...) WT9011_PRINTF_FORMAT(2, 3);
+void trace_packet(std::uint64_t timestamp_ns, const std::uint8_t* data, std::size_t length);
+
+void set_level(int level);
+// nullptr or "" selects stderr
+bool open(const char* path);
+// Writes traced packets in the capture format (see wt9011_capture.h), so a
+// trace can be replayed; nullptr or "" stops tracing
+bool trace_packets(const char* path);
+std::uint64_t dropped();
+// Drains the ring and joins the writer thread
+void shutdown();
+
+} // namespace log
+} // namespace wt9011
+
+#define WT9011_LOG(level, ...)                          \
+    do {                                                \
+        if (wt9011::log::enabled(level)) {              \
+            wt9011::log::write(level, __VA_ARGS__);     \
+        }                                               \
+    } while (0)
+
+#define WT9011_LOG_DISABLED(...) \
+    do {                         \
+    } while (0)
+
+#if WT9011_LOG_LEVEL <= WT9011_LOG_LEVEL_TRACE
+#define WT9011_LOG_TRACE(...) WT9011_LOG(WT9011_LOG_LEVEL_TRACE, __VA_ARGS__)
+#else
+#define WT9011_LOG_TRACE(...) WT9011_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if WT9011_LOG_LEVEL <= WT9011_LOG_LEVEL_DEBUG
+#define WT9011_LOG_DEBUG(...) WT9011_LOG(WT9011_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define WT9011_LOG_DEBUG(...) WT9011_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if WT9011_LOG_LEVEL <= WT9011_LOG_LEVEL_INFO
+#define WT9011_LOG_INFO(...) WT9011_LOG(WT9011_LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define WT9011_LOG_INFO(...) WT9011_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if WT9011_LOG_LEVEL <= WT9011_LOG_LEVEL_WARN
+#define WT9011_LOG_WARN(...) WT9011_LOG(WT9011_LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define WT9011_LOG_WARN(...) WT9011_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if WT9011_LOG_LEVEL <= WT9011_LOG_LEVEL_ERROR
+#define WT9011_LOG_ERROR(...) WT9011_LOG(WT9011_LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define WT9011_LOG_ERROR(...) WT9011_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if WT9011_LOG_PACKETS
+#define WT9011_LOG_PACKET(timestamp_ns, data, length)                     \
+    do {                                                                  \
+        if (wt9011::log::packet_trace_enabled()) {                        \
+            wt9011::log::trace_packet(timestamp_ns, data, length);        \
+        }                                                                 \
+    } while (0)
+#else
+#define WT9011_LOG_PACKET(timestamp_ns, data, length) \
+    do {                                              \
+    } while (0)
+#endif
+
+#endif // WT9011_LOG_H
@@ -0,0 +1,127 @@
+#include "wt9011_loop.h"
+#include <stdexcept>
+
+namespace wt9011 {
+
+EventLoopThread::~EventLoopThread() {
+    // stop() was never called (no wt9011_cleanup); the interpreter is gone by now
+    if (thread_.joinable()) {
+        thread_.detach();
+    }
+    loop_.release();
+}
+
+void EventLoopThread::start() {
+    if (loop_) {
+        return;
+    }
+    loop_ = py::module_::import("asyncio").attr("new_event_loop")();
+    py::handle loop = loop_;
+    thread_ = std::thread([loop]() {
+        py::gil_scoped_acquire acquire;
+        try {
+            py::module_::import("asyncio").attr("set_event_loop")(loop);
+            loop.attr("run_forever")();
+        } catch (const py::error_already_set&) {
+        }
+    });
+}
+
+void EventLoopThread::stop() {
+    if (!loop_) {
+        return;
+    }
+    loop_.attr("call_soon_threadsafe")(loop_.attr("stop"));
+    {
+        py::gil_scoped_release release;
+        thread_.join();
+    }
+    loop_.attr("close")();
+    loop_ = py::object();
+}
+
+py::object EventLoopThread::submit(py::object coro) {
+    if (!loop_) {
+        throw std::runtime_error("I/O loop is not running");
+    }
+    return py::module_::import("asyncio").attr("run_coroutine_threadsafe")(coro, loop_);
+}
+
+py::object EventLoopThread::run(py::object coro) {
+    // Future.result() waits on a lock, which releases the GIL while blocked
+    return submit(coro).attr("result")();
+}
+
+EventLoopThread& io_loop() {
+    static EventLoopThread loop;
+    return loop;
+}
+
+} // namespace wt9011
+
+WT9011_API int wt9011_op_wait(wt9011_op* op, int timeout_ms) {
+    if (!op) {
+        return -1;
+    }
+    if (op->read) {
+        return op->read->wait(timeout_ms);
+    }
+    if (op->native) {
+        return op->native_ok ? 1 : -1;
+    }
+    try {
+        py::gil_scoped_acquire acquire;
+        py::object timeout = timeout_ms < 0 ? py::object(py::none()) : py::object(py::float_(timeout_ms / 1000.0));
+        py::module_::import("concurrent.futures").attr("wait")(py::make_tuple(op->future), timeout);
+        if (!op->future.attr("done")().cast<bool>()) {
+            return 0;
+        }
+        if (op->future.attr("cancelled")().cast<bool>() || !op->future.attr("exception")().is_none()) {
+            return -1;
+        }
+        return 1;
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+WT9011_API bool wt9011_op_done(wt9011_op* op) {
+    if (op && op->read) {
+        return op->read->done();
+    }
+    if (!op || op->native) {
+        return true;
+    }
+    try {
+        py::gil_scoped_acquire acquire;
+        return op->future.attr("done")().cast<bool>();
+    } catch (const std::exception&) {
+        return true;
+    }
+}
+
+WT9011_API bool wt9011_op_registers(wt9011_op* op, unsigned short* values, size_t max) {
+    if (!op || !op->read || !values) {
+        return false;
+    }
+    std::uint16_t read[wt9011::kRegisterReplyValues];
+    if (!op->read->values(read)) {
+        return false;
+    }
+    for (std::size_t i = 0; i < max && i < wt9011::kRegisterReplyValues; ++i) {
+        values[i] = read[i];
+    }
+    return true;
+}
+
+WT9011_API void wt9011_op_free(wt9011_op* op) {
+    if (!op) {
+        return;
+    }
+    if (op->native) {
+        delete op;
+        return;
+    }
+    py::gil_scoped_acquire acquire;
+    delete op;
+}
@@ -0,0 +1,59 @@
+#ifndef WT9011_LOOP_H
+#define WT9011_LOOP_H
+
+#include <pybind11/pybind11.h>
+#include <memory>
+#include <thread>
+#include "wt9011_api.h"
+#include "wt9011_registers.h"
+
+namespace py = pybind11;
+
+namespace wt9011 {
+
+// Owns one asyncio event loop running forever on a dedicated thread.
+//
+// BLE notifications are delivered whenever the loop runs, so keeping it alive
+// between API calls lets data flow continuously. Coroutines are submitted with
+// asyncio.run_coroutine_threadsafe and complete independently of each other.
+// All methods must be called with the GIL held; the owning thread has to
+// release the GIL between API calls for the loop thread to make progress.
+class EventLoopThread {
+public:
+    EventLoopThread() = default;
+    EventLoopThread(const EventLoopThread&) = delete;
+    EventLoopThread& operator=(const EventLoopThread&) = delete;
+    ~EventLoopThread();
+
+    void start();
+    void stop();
+    bool running() const { return static_cast<bool>(loop_); }
+
+    // Schedule a coroutine; returns its concurrent.futures.Future
+    py::object submit(py::object coro);
+    // Schedule a coroutine and block until it finishes; rethrows its exception
+    py::object run(py::object coro);
+
+    py::object loop() const { return loop_; }
+
+private:
+    py::object loop_;
+    std::thread thread_;
+};
+
+// The loop shared by every connection in the process
+EventLoopThread& io_loop();
+
+} // namespace wt9011
+
+// Completion handle; holds the concurrent.futures.Future of a submitted coroutine.
+// Operations on native sources complete immediately and carry only their result.
+// Register reads complete natively when the reply frame arrives.
+struct wt9011_op {
+    py::object future;
+    bool native = false;
+    bool native_ok = false;
+    std::shared_ptr<wt9011::RegisterRead> read;
+};
+
+#endif // WT9011_LOOP_H
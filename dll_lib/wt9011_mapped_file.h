@@ -0,0 +1,38 @@
+#ifndef WT9011_MAPPED_FILE_H
+#define WT9011_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wt9011 {
+
+// Read-only memory mapping of a whole file (mmap / MapViewOfFile)
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Fails for missing or empty files
+    bool open(const std::string& path);
+    void close();
+
+    const std::uint8_t* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace wt9011
+
+#endif // WT9011_MAPPED_FILE_H
@@ -0,0 +1,357 @@
+#include "wt9011_recorder.h"
+#include <chrono>
+#include <cstring>
+
+namespace wt9011 {
+
+namespace {
+
+template <typename T>
+T* column(std::uint8_t* chunk, std::size_t index) {
+    return reinterpret_cast<T*>(chunk + chunk_column_offset(index));
+}
+
+} // namespace
+
+Recorder::~Recorder() {
+    close();
+}
+
+bool Recorder::open(const std::string& path) {
+    if (is_open()) {
+        return false;
+    }
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+
+    RecordingHeader header = {};
+    std::memcpy(header.magic, kRecordingMagic, sizeof(header.magic));
+    header.version = kRecordingVersion;
+    header.header_size = sizeof(RecordingHeader);
+    header.samples_per_chunk = static_cast<std::uint32_t>(kSamplesPerChunk);
+    header.column_count = static_cast<std::uint32_t>(kRecordingColumns);
+    header.chunk_size = kChunkSize;
+    header.created_unix_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+
+    buffers_.clear();
+    free_.clear();
+    for (std::size_t i = 0; i < kRecorderBuffers; ++i) {
+        buffers_.emplace_back(new std::uint64_t[kChunkSize / 8]);
+        free_.push_back(i);
+    }
+    pending_.clear();
+    index_.clear();
+    sensors_.clear();
+    has_active_ = false;
+    stopping_ = false;
+    write_failed_ = false;
+    samples_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+
+    open_.store(true, std::memory_order_release);
+    writer_ = std::thread(&Recorder::writer_main, this);
+    return true;
+}
+
+bool Recorder::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!open_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        open_.store(false, std::memory_order_release);
+        if (has_active_ && active_count_ > 0) {
+            submit_active();
+        } else if (has_active_) {
+            free_.push_back(active_);
+            has_active_ = false;
+        }
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    writer_.join();
+
+    bool ok = !write_failed_ && write_footer();
+    ok = std::fclose(file_) == 0 && ok;
+    file_ = nullptr;
+    buffers_.clear();
+    free_.clear();
+    return ok;
+}
+
+std::uint32_t Recorder::add_sensor(const std::string& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::size_t i = 0; i < sensors_.size(); ++i) {
+        if (sensors_[i] == address) {
+            return static_cast<std::uint32_t>(i);
+        }
+    }
+    sensors_.push_back(address);
+    return static_cast<std::uint32_t>(sensors_.size() - 1);
+}
+
+void Recorder::append(std::uint32_t sensor_id, const SensorSample& sample) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (!has_active_) {
+        if (free_.empty() || write_failed_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        active_ = free_.back();
+        free_.pop_back();
+        has_active_ = true;
+        active_count_ = 0;
+    }
+
+    std::uint8_t* chunk = reinterpret_cast<std::uint8_t*>(buffers_[active_].get());
+    const std::size_t i = active_count_;
+    const SensorData& d = sample.data;
+    const float channels[9] = {d.accel.x, d.accel.y, d.accel.z, d.gyro.x, d.gyro.y, d.gyro.z,
+                               d.angle.roll, d.angle.pitch, d.angle.yaw};
+    column<std::uint64_t>(chunk, 0)[i] = sample.timestamp_ns;
+    column<std::uint64_t>(chunk, 1)[i] = sample.sequence;
+    column<std::uint32_t>(chunk, 2)[i] = sensor_id;
+    for (std::size_t c = 0; c < 9; ++c) {
+        column<float>(chunk, 3 + c)[i] = channels[c];
+    }
+
+    if (i == 0) {
+        active_first_ns_ = sample.timestamp_ns;
+    }
+    active_last_ns_ = sample.timestamp_ns;
+    ++active_count_;
+    samples_.fetch_add(1, std::memory_order_relaxed);
+    if (active_count_ == kSamplesPerChunk) {
+        submit_active();
+    }
+}
+
+// Hand the active chunk to the writer thread; mutex_ held
+void Recorder::submit_active() {
+    std::uint8_t* chunk = reinterpret_cast<std::uint8_t*>(buffers_[active_].get());
+    if (active_count_ < kSamplesPerChunk) {
+        const std::size_t unused = kSamplesPerChunk - active_count_;
+        for (std::size_t c = 0; c < kRecordingColumns; ++c) {
+            const std::size_t width = c < 2 ? 8 : 4;
+            std::memset(chunk + chunk_column_offset(c) + width * active_count_, 0, width * unused);
+        }
+    }
+
+    ChunkHeader header = {};
+    header.magic = kChunkMagic;
+    header.count = active_count_;
+    header.first_timestamp_ns = active_first_ns_;
+    header.last_timestamp_ns = active_last_ns_;
+    std::memcpy(chunk, &header, sizeof(header));
+
+    ChunkIndexEntry entry = {};
+    entry.first_timestamp_ns = active_first_ns_;
+    entry.last_timestamp_ns = active_last_ns_;
+    entry.count = active_count_;
+    index_.push_back(entry);
+
+    pending_.push_back(active_);
+    has_active_ = false;
+    cv_.notify_one();
+}
+
+void Recorder::writer_main() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            break;
+        }
+        const std::size_t buffer = pending_.front();
+        pending_.pop_front();
+        lock.unlock();
+        const bool ok = std::fwrite(buffers_[buffer].get(), 1, kChunkSize, file_) == kChunkSize;
+        lock.lock();
+        if (!ok) {
+            write_failed_ = true;
+        }
+        free_.push_back(buffer);
+    }
+}
+
+bool Recorder::write_footer() {
+    RecordingTrailer trailer = {};
+    trailer.index_offset = sizeof(RecordingHeader) + static_cast<std::uint64_t>(index_.size()) * kChunkSize;
+    trailer.total_samples = samples_.load(std::memory_order_relaxed);
+    trailer.chunk_count = static_cast<std::uint32_t>(index_.size());
+    trailer.sensor_count = static_cast<std::uint32_t>(sensors_.size());
+    trailer.magic = kTrailerMagic;
+
+    if (!index_.empty() && std::fwrite(index_.data(), sizeof(ChunkIndexEntry), index_.size(), file_) != index_.size()) {
+        return false;
+    }
+    for (const std::string& address : sensors_) {
+        SensorEntry entry = {};
+        std::strncpy(entry.address, address.c_str(), kSensorAddressSize - 1);
+        if (std::fwrite(&entry, sizeof(entry), 1, file_) != 1) {
+            return false;
+        }
+    }
+    return std::fwrite(&trailer, sizeof(trailer), 1, file_) == 1 && std::fflush(file_) == 0;
+}
+
+bool RecordingReader::open(const std::string& path) {
+    close();
+    if (!file_.open(path) || file_.size() < sizeof(RecordingHeader)) {
+        close();
+        return false;
+    }
+
+    RecordingHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, kRecordingMagic, sizeof(header.magic)) != 0 ||
+        header.version != kRecordingVersion || header.header_size != sizeof(RecordingHeader) ||
+        header.samples_per_chunk != kSamplesPerChunk || header.column_count != kRecordingColumns ||
+        header.chunk_size != kChunkSize) {
+        close();
+        return false;
+    }
+
+    const std::size_t body = file_.size() - sizeof(RecordingHeader);
+    RecordingTrailer trailer = {};
+    if (body >= sizeof(trailer)) {
+        std::memcpy(&trailer, file_.data() + file_.size() - sizeof(trailer), sizeof(trailer));
+    }
+    const std::uint64_t footer_size = static_cast<std::uint64_t>(trailer.chunk_count) * sizeof(ChunkIndexEntry) +
+                                      static_cast<std::uint64_t>(trailer.sensor_count) * sizeof(SensorEntry) +
+                                      sizeof(RecordingTrailer);
+    const bool complete = trailer.magic == kTrailerMagic &&
+        trailer.index_offset == sizeof(RecordingHeader) + static_cast<std::uint64_t>(trailer.chunk_count) * kChunkSize &&
+        trailer.index_offset + footer_size == file_.size();
+
+    if (complete) {
+        chunk_count_ = trailer.chunk_count;
+        sensor_count_ = trailer.sensor_count;
+        sensors_ = reinterpret_cast<const SensorEntry*>(
+            file_.data() + trailer.index_offset + static_cast<std::uint64_t>(trailer.chunk_count) * sizeof(ChunkIndexEntry));
+    } else {
+        // Writer did not finish: take every whole chunk, no sensor table
+        chunk_count_ = body / kChunkSize;
+    }
+    return true;
+}
+
+void RecordingReader::close() {
+    file_.close();
+    chunk_count_ = 0;
+    sensor_count_ = 0;
+    sensors_ = nullptr;
+}
+
+const char* RecordingReader::sensor_address(std::uint32_t sensor_id) const {
+    return sensor_id < sensor_count_ ? sensors_[sensor_id].address : nullptr;
+}
+
+bool RecordingReader::chunk(std::size_t index, RecordingChunk& out) const {
+    if (index >= chunk_count_) {
+        return false;
+    }
+    const std::uint8_t* base = file_.data() + sizeof(RecordingHeader) + index * kChunkSize;
+    ChunkHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (header.magic != kChunkMagic || header.count > kSamplesPerChunk) {
+        return false;
+    }
+
+    auto floats = [base](std::size_t c) { return reinterpret_cast<const float*>(base + chunk_column_offset(c)); };
+    out.count = header.count;
+    out.timestamp_ns = reinterpret_cast<const unsigned long long*>(base + chunk_column_offset(0));
+    out.sequence = reinterpret_cast<const unsigned long long*>(base + chunk_column_offset(1));
+    out.sensor_id = reinterpret_cast<const unsigned int*>(base + chunk_column_offset(2));
+    out.ax = floats(3);
+    out.ay = floats(4);
+    out.az = floats(5);
+    out.gx = floats(6);
+    out.gy = floats(7);
+    out.gz = floats(8);
+    out.roll = floats(9);
+    out.pitch = floats(10);
+    out.yaw = floats(11);
+    return true;
+}
+
+} // namespace wt9011
+
+WT9011_API wt9011_recorder* wt9011_recorder_open(const char* path) {
+    if (!path) {
+        return nullptr;
+    }
+    try {
+        auto handle = std::make_unique<wt9011_recorder>();
+        handle->recorder = std::make_shared<wt9011::Recorder>();
+        if (!handle->recorder->open(path)) {
+            return nullptr;
+        }
+        return handle.release();
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+WT9011_API bool wt9011_recorder_close(wt9011_recorder* recorder) {
+    if (!recorder) {
+        return false;
+    }
+    const bool ok = recorder->recorder->close();
+    delete recorder;
+    return ok;
+}
+
+WT9011_API unsigned long long wt9011_recorder_samples(const wt9011_recorder* recorder) {
+    return recorder ? recorder->recorder->samples() : 0;
+}
+
+WT9011_API unsigned long long wt9011_recorder_dropped(const wt9011_recorder* recorder) {
+    return recorder ? recorder->recorder->dropped() : 0;
+}
+
+WT9011_API wt9011_recording* wt9011_recording_open(const char* path) {
+    if (!path) {
+        return nullptr;
+    }
+    try {
+        auto handle = std::make_unique<wt9011_recording>();
+        if (!handle->reader.open(path)) {
+            return nullptr;
+        }
+        return handle.release();
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+WT9011_API void wt9011_recording_close(wt9011_recording* recording) {
+    delete recording;
+}
+
+WT9011_API size_t wt9011_recording_chunk_count(const wt9011_recording* recording) {
+    return recording ? recording->reader.chunk_count() : 0;
+}
+
+WT9011_API bool wt9011_recording_chunk(const wt9011_recording* recording, size_t index, RecordingChunk* out) {
+    return recording && out && recording->reader.chunk(index, *out);
+}
+
+WT9011_API size_t wt9011_recording_sensor_count(const wt9011_recording* recording) {
+    return recording ? recording->reader.sensor_count() : 0;
+}
+
+WT9011_API const char* wt9011_recording_sensor(const wt9011_recording* recording, unsigned int sensor_id) {
+    return recording ? recording->reader.sensor_address(sensor_id) : nullptr;
+}
@@ -0,0 +1,183 @@
+#ifndef WT9011_RECORDER_H
+#define WT9011_RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "wt9011_api.h"
+#include "wt9011_types.h"
+#include "wt9011_mapped_file.h"
+
+namespace wt9011 {
+
+// Recording file layout (little endian, every block 8-byte aligned):
+//
+//   RecordingHeader                      64 bytes
+//   chunk 0 .. chunk N-1                 kChunkSize bytes each
+//     ChunkHeader                        32 bytes
+//     timestamp_ns  u64[kSamplesPerChunk]
+//     sequence      u64[kSamplesPerChunk]
+//     sensor_id     u32[kSamplesPerChunk]
+//     ax ay az gx gy gz roll pitch yaw   f32[kSamplesPerChunk] each
+//   ChunkIndexEntry[N]                   footer index
+//   SensorEntry[sensor_count]            sensor addresses
+//   RecordingTrailer                     32 bytes, last in file
+//
+// Chunks are fixed size, so chunk i starts at sizeof(RecordingHeader) + i * kChunkSize.
+// A file without a trailer (crashed writer) is still readable chunk by chunk.
+
+constexpr char kRecordingMagic[8] = {'W', 'T', '9', '0', '1', '1', 'R', 'C'};
+constexpr std::uint32_t kRecordingVersion = 1;
+constexpr std::uint32_t kChunkMagic = 0x4B435457;   // "WTCK"
+constexpr std::uint32_t kTrailerMagic = 0x58495457; // "WTIX"
+constexpr std::size_t kSamplesPerChunk = 4096;
+constexpr std::size_t kRecordingColumns = 12;
+constexpr std::size_t kSensorAddressSize = 64;
+
+struct RecordingHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::uint32_t samples_per_chunk;
+    std::uint32_t column_count;
+    std::uint64_t chunk_size;
+    std::uint64_t created_unix_ns;
+    std::uint8_t reserved[24];
+};
+
+struct ChunkHeader {
+    std::uint32_t magic;
+    std::uint32_t count;
+    std::uint64_t first_timestamp_ns;
+    std::uint64_t last_timestamp_ns;
+    std::uint64_t reserved;
+};
+
+struct ChunkIndexEntry {
+    std::uint64_t first_timestamp_ns;
+    std::uint64_t last_timestamp_ns;
+    std::uint32_t count;
+    std::uint32_t reserved;
+};
+
+struct SensorEntry {
+    char address[kSensorAddressSize];
+};
+
+struct RecordingTrailer {
+    std::uint64_t index_offset;
+    std::uint64_t total_samples;
+    std::uint32_t chunk_count;
+    std::uint32_t sensor_count;
+    std::uint32_t reserved;
+    std::uint32_t magic;
+};
+
+static_assert(sizeof(RecordingHeader) == 64, "RecordingHeader layout");
+static_assert(sizeof(ChunkHeader) == 32, "ChunkHeader layout");
+static_assert(sizeof(ChunkIndexEntry) == 24, "ChunkIndexEntry layout");
+static_assert(sizeof(RecordingTrailer) == 32, "RecordingTrailer layout");
+
+// Byte offset of a column inside a chunk (0 timestamp, 1 sequence, 2 sensor id, 3..11 channels)
+constexpr std::size_t chunk_column_offset(std::size_t column) {
+    return column == 0 ? sizeof(ChunkHeader)
+         : column == 1 ? sizeof(ChunkHeader) + 8 * kSamplesPerChunk
+         : column == 2 ? sizeof(ChunkHeader) + 16 * kSamplesPerChunk
+         : sizeof(ChunkHeader) + 20 * kSamplesPerChunk + 4 * kSamplesPerChunk * (column - 3);
+}
+
+constexpr std::size_t kChunkSize = chunk_column_offset(kRecordingColumns);
+
+// Streams samples of one or more sensors to a recording file.
+//
+// append() fills the active chunk under a short lock; full chunks are written
+// by a background thread. Memory is a fixed pool of kRecorderBuffers chunks;
+// if the disk falls that far behind, samples are dropped and counted.
+class Recorder {
+public:
+    static constexpr std::size_t kRecorderBuffers = 4;
+
+    Recorder() = default;
+    ~Recorder();
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    bool open(const std::string& path);
+    // Flush, write the footer and close the file; false if any write failed
+    bool close();
+
+    // Register a sensor and return its id; the same address keeps its id
+    std::uint32_t add_sensor(const std::string& address);
+    void append(std::uint32_t sensor_id, const SensorSample& sample);
+
+    bool is_open() const { return open_.load(std::memory_order_acquire); }
+    std::uint64_t samples() const { return samples_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void submit_active();
+    void writer_main();
+    bool write_footer();
+
+    std::FILE* file_ = nullptr;
+    std::thread writer_;
+    std::atomic<bool> open_{false};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::unique_ptr<std::uint64_t[]>> buffers_; // u64 keeps every column aligned
+    std::vector<std::size_t> free_;
+    std::deque<std::size_t> pending_;
+    std::size_t active_ = 0;
+    bool has_active_ = false;
+    std::uint32_t active_count_ = 0;
+    std::uint64_t active_first_ns_ = 0;
+    std::uint64_t active_last_ns_ = 0;
+    std::vector<ChunkIndexEntry> index_;
+    std::vector<std::string> sensors_;
+    bool stopping_ = false;
+    bool write_failed_ = false;
+
+    std::atomic<std::uint64_t> samples_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
+// Zero-copy reader over a memory-mapped recording
+class RecordingReader {
+public:
+    bool open(const std::string& path);
+    void close();
+
+    std::size_t chunk_count() const { return chunk_count_; }
+    std::size_t sensor_count() const { return sensor_count_; }
+    // Null for unknown ids
+    const char* sensor_address(std::uint32_t sensor_id) const;
+    bool chunk(std::size_t index, RecordingChunk& out) const;
+
+private:
+    MappedFile file_;
+    std::size_t chunk_count_ = 0;
+    std::size_t sensor_count_ = 0;
+    const SensorEntry* sensors_ = nullptr;
+};
+
+} // namespace wt9011
+
+// C handles; the session keeps its own reference to the recorder
+struct wt9011_recorder {
+    std::shared_ptr<wt9011::Recorder> recorder;
+};
+
+struct wt9011_recording {
+    wt9011::RecordingReader reader;
+};
+
+#endif // WT9011_RECORDER_H
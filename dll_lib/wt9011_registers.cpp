@@ -0,0 +1,133 @@
+#include "wt9011_registers.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "wt9011_clock.h"
+
+namespace wt9011 {
+
+namespace {
+
+std::chrono::steady_clock::time_point to_time_point(std::uint64_t ns) {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+} // namespace
+
+void RegisterRead::complete(const std::uint16_t* values) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != 0) {
+            return;
+        }
+        std::memcpy(values_, values, sizeof(values_));
+        state_ = 1;
+    }
+    cv_.notify_all();
+}
+
+void RegisterRead::fail() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != 0) {
+            return;
+        }
+        state_ = -1;
+    }
+    cv_.notify_all();
+}
+
+int RegisterRead::poll_locked(std::uint64_t now_ns) {
+    if (state_ == 0 && now_ns >= deadline_ns_) {
+        state_ = -1;
+    }
+    return state_;
+}
+
+int RegisterRead::wait(int timeout_ms) {
+    std::uint64_t until = deadline_ns_;
+    if (timeout_ms >= 0) {
+        until = std::min<std::uint64_t>(until, monotonic_ns() + static_cast<std::uint64_t>(timeout_ms) * 1000000ull);
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_until(lock, to_time_point(until), [this] { return state_ != 0; });
+    return poll_locked(monotonic_ns());
+}
+
+bool RegisterRead::done() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return poll_locked(monotonic_ns()) != 0;
+}
+
+bool RegisterRead::values(std::uint16_t* out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != 1) {
+        return false;
+    }
+    std::memcpy(out, values_, sizeof(values_));
+    return true;
+}
+
+std::shared_ptr<RegisterRead> RegisterReads::start(std::uint8_t reg, int timeout_ms) {
+    const std::uint64_t now = monotonic_ns();
+    const std::uint64_t timeout_ns =
+        static_cast<std::uint64_t>(timeout_ms < 0 ? kDefaultReadTimeoutMs : timeout_ms) * 1000000ull;
+    auto read = std::make_shared<RegisterRead>(reg, now + timeout_ns);
+    std::lock_guard<std::mutex> lock(mutex_);
+    expire_locked(now);
+    pending_.push_back(read);
+    return read;
+}
+
+void RegisterReads::cancel(const std::shared_ptr<RegisterRead>& read) {
+    read->fail();
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.erase(std::remove(pending_.begin(), pending_.end(), read), pending_.end());
+}
+
+bool RegisterReads::on_reply(const std::uint8_t* frame) {
+    std::uint16_t first = 0;
+    std::uint16_t values[kRegisterReplyValues];
+    if (!decode_register_frame(frame, kFrameSize, first, values)) {
+        return false;
+    }
+    std::shared_ptr<RegisterRead> read;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        expire_locked(monotonic_ns());
+        auto it = std::find_if(pending_.begin(), pending_.end(),
+                               [first](const std::shared_ptr<RegisterRead>& r) { return r->reg() == first; });
+        if (it == pending_.end()) {
+            return false;
+        }
+        read = std::move(*it);
+        pending_.erase(it);
+    }
+    read->complete(values);
+    return true;
+}
+
+void RegisterReads::fail_all() {
+    std::vector<std::shared_ptr<RegisterRead>> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending.swap(pending_);
+    }
+    for (auto& read : pending) {
+        read->fail();
+    }
+}
+
+void RegisterReads::expire_locked(std::uint64_t now_ns) {
+    auto expired = std::remove_if(pending_.begin(), pending_.end(), [now_ns](const std::shared_ptr<RegisterRead>& r) {
+        if (r->deadline_ns() > now_ns) {
+            return false;
+        }
+        r->fail();
+        return true;
+    });
+    pending_.erase(expired, pending_.end());
+}
+
+} // namespace wt9011
@@ -0,0 +1,66 @@
+#ifndef WT9011_REGISTERS_H
+#define WT9011_REGISTERS_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "wt9011_decoder.h"
+
+namespace wt9011 {
+
+// Used when a read is started with a negative timeout
+constexpr int kDefaultReadTimeoutMs = 1000;
+
+// One outstanding register read, completed by the matching 0x55 0x71 reply
+// or failed once its deadline passes
+class RegisterRead {
+public:
+    RegisterRead(std::uint8_t reg, std::uint64_t deadline_ns) : reg_(reg), deadline_ns_(deadline_ns) {}
+
+    std::uint8_t reg() const { return reg_; }
+    std::uint64_t deadline_ns() const { return deadline_ns_; }
+
+    void complete(const std::uint16_t* values);
+    void fail();
+
+    // 1 when the reply arrived, 0 if `timeout_ms` (< 0: no limit) ran out
+    // first, -1 if the read failed or its own deadline expired
+    int wait(int timeout_ms);
+    bool done();
+    // kRegisterReplyValues registers starting at reg(); false unless completed
+    bool values(std::uint16_t* out) const;
+
+private:
+    int poll_locked(std::uint64_t now_ns);
+
+    const std::uint8_t reg_;
+    const std::uint64_t deadline_ns_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    int state_ = 0;
+    std::uint16_t values_[kRegisterReplyValues] = {};
+};
+
+// Reads in flight on one session. Replies carry only the register address,
+// so they complete the oldest unexpired read of that register.
+class RegisterReads {
+public:
+    std::shared_ptr<RegisterRead> start(std::uint8_t reg, int timeout_ms);
+    void cancel(const std::shared_ptr<RegisterRead>& read);
+    // Delivering thread; false if no read was waiting for this reply
+    bool on_reply(const std::uint8_t* frame);
+    void fail_all();
+
+private:
+    void expire_locked(std::uint64_t now_ns);
+
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<RegisterRead>> pending_;
+};
+
+} // namespace wt9011
+
+#endif // WT9011_REGISTERS_H
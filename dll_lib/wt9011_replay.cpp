@@ -0,0 +1,95 @@
+#include "wt9011_replay.h"
+#include <chrono>
+#include <memory>
+#include "wt9011_capture.h"
+#include "wt9011_clock.h"
+#include "wt9011_session.h"
+
+namespace wt9011 {
+
+ReplaySource::~ReplaySource() {
+    stop();
+}
+
+bool ReplaySource::open(const std::string& path) {
+    return file_.open(path) && CaptureCursor(file_.data(), file_.size()).valid();
+}
+
+bool ReplaySource::start(wt9011_session& session) {
+    if (thread_.joinable() || !file_.data()) {
+        return false;
+    }
+    stopping_ = false;
+    finished_.store(false, std::memory_order_release);
+    thread_ = std::thread(&ReplaySource::run, this, std::ref(session));
+    return true;
+}
+
+void ReplaySource::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ReplaySource::run(wt9011_session& session) {
+    const bool paced = speed_ > 0.0;
+    CaptureCursor cursor(file_.data(), file_.size());
+    std::uint64_t pass_start = monotonic_ns();
+
+    for (;;) {
+        CaptureRecord record;
+        std::uint64_t first_ns = 0;
+        std::uint64_t last_stamp = pass_start;
+        bool empty = true;
+        cursor.rewind();
+        while (cursor.next(record)) {
+            if (empty) {
+                first_ns = record.timestamp_ns;
+                empty = false;
+            }
+            const double offset = record.timestamp_ns > first_ns ? static_cast<double>(record.timestamp_ns - first_ns) : 0.0;
+            const std::uint64_t stamp = pass_start + static_cast<std::uint64_t>(paced ? offset / speed_ : offset);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (paced) {
+                const auto due = std::chrono::steady_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(stamp)));
+                cv_.wait_until(lock, due, [this] { return stopping_; });
+            }
+            if (stopping_) {
+                return;
+            }
+            lock.unlock();
+
+            session.on_notification(record.data, record.length, stamp);
+            last_stamp = stamp;
+        }
+        if (!loop_ || empty) {
+            break;
+        }
+        pass_start = paced ? monotonic_ns() : last_stamp + 1;
+    }
+    finished_.store(true, std::memory_order_release);
+}
+
+} // namespace wt9011
+
+WT9011_API wt9011_session* wt9011_replay_open(const char* path, double speed, bool loop) {
+    if (!path) {
+        return nullptr;
+    }
+    try {
+        auto source = std::make_unique<wt9011::ReplaySource>(speed, loop);
+        if (!source->open(path)) {
+            return nullptr;
+        }
+        return wt9011::open_source_session(std::string("replay:") + path, std::move(source));
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef WT9011_REPLAY_H
+#define WT9011_REPLAY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "wt9011_source.h"
+#include "wt9011_mapped_file.h"
+
+namespace wt9011 {
+
+// Plays a raw notification capture back into a session.
+//
+// With speed > 0 notifications are paced by their recorded spacing divided by
+// `speed` (1 = real time) and stamped with their delivery time. With speed <= 0
+// they are delivered as fast as the pipeline takes them, stamped with the
+// recorded spacing so time-based processing sees the original timeline.
+class ReplaySource : public NotificationSource {
+public:
+    ReplaySource(double speed, bool loop) : speed_(speed), loop_(loop) {}
+    ~ReplaySource() override;
+
+    bool open(const std::string& path);
+
+    bool start(wt9011_session& session) override;
+    void stop() override;
+    // Commands are accepted and ignored
+    bool write(const std::uint8_t*, std::size_t) override { return true; }
+    bool finished() const override { return finished_.load(std::memory_order_acquire); }
+
+private:
+    void run(wt9011_session& session);
+
+    MappedFile file_;
+    const double speed_;
+    const bool loop_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::atomic<bool> finished_{false};
+};
+
+} // namespace wt9011
+
+#endif // WT9011_REPLAY_H
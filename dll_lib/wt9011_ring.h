@@ -0,0 +1,77 @@
+#ifndef WT9011_RING_H
+#define WT9011_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace wt9011 {
+
+// Bounded lock-free single-producer/single-consumer ring.
+//
+// Exactly one thread may push and exactly one (other) thread may pop. Storage
+// is allocated with the ring; push and pop never allocate. Each side keeps a
+// cached copy of the other side's index so the shared cache line is only read
+// when the ring looks full (producer) or empty (consumer).
+template <typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (and leaves the ring untouched) if full.
+    bool try_push(const T& item) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == Capacity) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ == Capacity) {
+                return false;
+            }
+        }
+        slots_[head & (Capacity - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Moves up to `max` items into `out`, oldest first.
+    std::size_t pop(T* out, std::size_t max) {
+        return consume(max, [out](std::size_t i, const T& item) { out[i] = item; });
+    }
+
+    // Consumer side. Calls visit(index, item) for up to `max` items, oldest
+    // first, then releases their slots in one store.
+    template <typename Visit>
+    std::size_t consume(std::size_t max, Visit&& visit) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t available = head_cache_ - tail;
+        if (available < max) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            available = head_cache_ - tail;
+        }
+        const std::size_t n = available < max ? available : max;
+        for (std::size_t i = 0; i < n; ++i) {
+            visit(i, static_cast<const T&>(slots_[(tail + i) & (Capacity - 1)]));
+        }
+        if (n > 0) {
+            tail_.store(tail + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Approximate when called concurrently with push/pop
+    std::size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t tail_cache_ = 0;
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t head_cache_ = 0;
+    alignas(64) std::array<T, Capacity> slots_{};
+};
+
+} // namespace wt9011
+
+#endif // WT9011_RING_H
@@ -0,0 +1,746 @@
+#include "wt9011_session.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include "wt9011_clock.h"
+#include "wt9011_commands.h"
+#include "wt9011_decoder.h"
+#include "wt9011_dispatch.h"
+#include "wt9011_log.h"
+#include "wt9011_loop.h"
+#include "wt9011_sim.h"
+#include "wt9011_stats.h"
+
+namespace {
+
+// Lock order: the GIL (if needed) is always taken before sessions_mutex
+std::mutex sessions_mutex;
+std::vector<std::shared_ptr<wt9011_session>> sessions;
+py::object ble_manager_class;
+
+std::shared_ptr<wt9011_session> find_session(wt9011_session* session) {
+    std::lock_guard<std::mutex> lock(sessions_mutex);
+    auto it = std::find_if(sessions.begin(), sessions.end(),
+                           [session](const std::shared_ptr<wt9011_session>& s) { return s.get() == session; });
+    return it != sessions.end() ? *it : nullptr;
+}
+
+// Stop the source, pending reads and capture; the BLE link is left to the
+// caller. GIL held unless the session is fed by a native source
+bool stop_session(wt9011_session* session) {
+    session->closed.store(true, std::memory_order_release);
+    bool ok = true;
+    if (session->source) {
+        session->source->stop();
+    }
+    session->reads.fail_all();
+    if (std::shared_ptr<wt9011::CaptureWriter> capture = std::atomic_load(&session->capture)) {
+        ok = capture->close() && ok;
+    }
+    return ok;
+}
+
+// Disconnect and break the session <-> handler reference cycle; GIL held
+// unless the session is fed by a native source
+bool shutdown_session(wt9011_session* session) {
+    bool ok = stop_session(session);
+    if (session->manager) {
+        try {
+            wt9011::io_loop().run(session->manager.attr("disconnect")());
+        } catch (const std::exception&) {
+            ok = false;
+        }
+        session->manager = py::object();
+    }
+    return ok;
+}
+
+// Stop delivery and wait for a callback that may be running on a dispatch
+// worker; call without the GIL, which that callback may be waiting for
+void quiesce_session(wt9011_session* session) {
+    session->closed.store(true, std::memory_order_release);
+    if (!wt9011::Dispatcher::on_worker_thread()) {
+        std::lock_guard<std::mutex> lock(session->dispatch_mutex);
+    }
+}
+
+// bleak handler side: copy the notification out of its Python buffer and
+// leave decoding and callbacks to the session's dispatch worker. A payload
+// longer than kMaxNotification is queued in consecutive pieces, so the
+// assembler still sees every byte; each piece counts as a notification.
+void enqueue_notification(const std::shared_ptr<wt9011_session>& session, const std::uint8_t* data,
+                          std::size_t length, std::uint64_t timestamp_ns) {
+    if (session->closed.load(std::memory_order_acquire)) {
+        return;
+    }
+    wt9011::RawPacket packet;
+    packet.timestamp_ns = timestamp_ns;
+    std::size_t offset = 0;
+    bool queued = false;
+    do {
+        packet.length = static_cast<std::uint16_t>(std::min(length - offset, wt9011::kMaxNotification));
+        std::memcpy(packet.data, data + offset, packet.length);
+        if (!session->packets.try_push(packet)) {
+            wt9011::counters().dispatch_drops.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        queued = true;
+        offset += packet.length;
+    } while (offset < length);
+    if (queued) {
+        wt9011::dispatcher().post(session);
+    }
+}
+
+} // namespace
+
+wt9011_session::wt9011_session(std::string address) : address(std::move(address)) {}
+
+void wt9011_session::on_notification(const std::uint8_t* data, std::size_t length, std::uint64_t timestamp_ns) {
+    if (closed.load(std::memory_order_acquire)) {
+        return;
+    }
+    wt9011::PipelineCounters& stats = wt9011::counters();
+    const std::uint64_t entered_ns = wt9011::monotonic_ns();
+    stats.packets.fetch_add(1, std::memory_order_relaxed);
+    stats.bytes.fetch_add(length, std::memory_order_relaxed);
+    if (std::shared_ptr<wt9011::CaptureWriter> writer = std::atomic_load(&capture)) {
+        writer->append(timestamp_ns, data, length);
+    }
+    WT9011_LOG_PACKET(timestamp_ns, data, length);
+    std::shared_ptr<const wt9011::RecorderLink> link = std::atomic_load(&recording);
+    if (link && !link->recorder->is_open()) {
+        // Recorder was closed behind our back; let go of it
+        std::atomic_store(&recording, std::shared_ptr<const wt9011::RecorderLink>());
+        link.reset();
+    }
+    const std::shared_ptr<wt9011::FilterChain> chain = std::atomic_load(&filters);
+    const std::shared_ptr<wt9011::FusionStage> fusion_stage = std::atomic_load(&fusion);
+    const std::shared_ptr<wt9011::WindowSet> window_set = std::atomic_load(&windows);
+    const std::shared_ptr<wt9011::SpectrumStage> spectrum_stage = std::atomic_load(&spectrum);
+    if (length == wt9011::kChecksummedFrameSize && assembler.pending() == 0 && data[0] == wt9011::kFrameHeader &&
+        data[1] == wt9011::kFrameTypeData) {
+        // One frame and its checksum byte: verify, then assemble the frame alone
+        if (data[wt9011::kFrameSize] != wt9011::frame_checksum(data)) {
+            stats.rejected_frames.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        length = wt9011::kFrameSize;
+    }
+    const std::uint64_t discarded_before = assembler.discarded_bytes();
+    const std::uint64_t resyncs_before = assembler.resyncs();
+    assembler.feed(data, length, [this, timestamp_ns, entered_ns, &link, &chain, &fusion_stage, &window_set,
+                                  &spectrum_stage, &stats](const std::uint8_t* frame) {
+        if (frame[1] == wt9011::kFrameTypeRegister) {
+            if (!reads.on_reply(frame)) {
+                // Malformed, or no read is waiting for that register
+                stats.rejected_frames.fetch_add(1, std::memory_order_relaxed);
+            }
+            return;
+        }
+        SensorSample sample;
+        if (!wt9011::decode_frame(frame, wt9011::kFrameSize, sample.data)) {
+            stats.rejected_frames.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Measured from entry rather than timestamp_ns, which replays may synthesize
+        const std::uint64_t decoded_ns = wt9011::monotonic_ns();
+        stats.frames.fetch_add(1, std::memory_order_relaxed);
+        stats.notify_to_decode.record(decoded_ns - entered_ns);
+        if (chain && !chain->process(sample.data)) {
+            return; // Decimated
+        }
+
+        sample.timestamp_ns = timestamp_ns;
+        sample.sequence = next_sequence++;
+        if (link) {
+            link->recorder->append(link->sensor_id, sample);
+        }
+        if (window_set) {
+            for (auto& window : window_set->windows) {
+                window->add(sample);
+            }
+        }
+        if (spectrum_stage && spectrum_stage->analyzer->add(sample) && spectrum_stage->callback) {
+            spectrum_stage->callback(this, &spectrum_stage->analyzer->report(), spectrum_stage->user);
+        }
+        if (fusion_stage) {
+            FusedSample fused;
+            fusion_stage->bank.update(0, &sample, 1, &fused);
+            if (fusion_stage->callback) {
+                fusion_stage->callback(this, &fused, fusion_stage->user);
+            }
+        }
+        if (callback) {
+            const std::uint64_t callback_ns = wt9011::monotonic_ns();
+            stats.decode_to_callback.record(callback_ns - decoded_ns);
+            callback(this, &sample, user);
+            stats.callback_duration.record(wt9011::monotonic_ns() - callback_ns);
+            stats.callbacks.fetch_add(1, std::memory_order_relaxed);
+        } else if (!queue.try_push(sample)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            stats.queue_drops.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    const std::uint64_t discarded = assembler.discarded_bytes() - discarded_before;
+    if (discarded > 0) {
+        stats.discarded_bytes.fetch_add(discarded, std::memory_order_relaxed);
+    }
+    const std::uint64_t resyncs = assembler.resyncs() - resyncs_before;
+    if (resyncs > 0) {
+        stats.rejected_frames.fetch_add(resyncs, std::memory_order_relaxed);
+    }
+}
+
+bool wt9011_session::drain_packets(std::size_t max) {
+    std::lock_guard<std::mutex> lock(dispatch_mutex);
+    wt9011::PipelineCounters& stats = wt9011::counters();
+    packets.consume(max, [this, &stats](std::size_t, const wt9011::RawPacket& packet) {
+        stats.dispatch_wait.record(wt9011::monotonic_ns() - packet.timestamp_ns);
+        on_notification(packet.data, packet.length, packet.timestamp_ns);
+    });
+    return packets.size() > 0;
+}
+
+namespace wt9011 {
+
+void set_ble_manager_class(py::object cls) {
+    ble_manager_class = std::move(cls);
+}
+
+void close_all_sessions() {
+    std::vector<std::shared_ptr<wt9011_session>> open;
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        open.swap(sessions);
+    }
+    // Sim and replay sessions work without wt9011_init; with no interpreter
+    // there is no GIL to release
+    const bool python = Py_IsInitialized() != 0;
+    {
+        std::unique_ptr<py::gil_scoped_release> release;
+        if (python) {
+            release = std::make_unique<py::gil_scoped_release>();
+        }
+        for (auto& session : open) {
+            quiesce_session(session.get());
+        }
+    }
+    for (auto& session : open) {
+        shutdown_session(session.get());
+    }
+    open.clear();
+    if (!python) {
+        dispatcher().stop();
+        return;
+    }
+    ble_manager_class = py::object();
+    {
+        py::gil_scoped_release release;
+        dispatcher().stop();
+    }
+}
+
+void set_session_callback(wt9011_session& session, SessionSampleCallback callback, void* user) {
+    std::unique_lock<std::mutex> lock(session.dispatch_mutex, std::defer_lock);
+    if (!Dispatcher::on_worker_thread()) {
+        lock.lock();
+    }
+    session.callback = callback;
+    session.user = user;
+}
+
+wt9011_session* open_source_session(const std::string& address, std::unique_ptr<NotificationSource> source) {
+    auto session = std::make_shared<wt9011_session>(address);
+    session->source = std::move(source);
+    std::lock_guard<std::mutex> lock(sessions_mutex);
+    sessions.push_back(session);
+    return session.get();
+}
+
+bool get_notification_buffer(py::handle data, const std::uint8_t*& buffer, std::size_t& length) {
+    if (PyByteArray_Check(data.ptr())) {
+        buffer = reinterpret_cast<const std::uint8_t*>(PyByteArray_AS_STRING(data.ptr()));
+        length = static_cast<std::size_t>(PyByteArray_GET_SIZE(data.ptr()));
+        return true;
+    }
+    if (PyBytes_Check(data.ptr())) {
+        buffer = reinterpret_cast<const std::uint8_t*>(PyBytes_AS_STRING(data.ptr()));
+        length = static_cast<std::size_t>(PyBytes_GET_SIZE(data.ptr()));
+        return true;
+    }
+    return false;
+}
+
+} // namespace wt9011
+
+WT9011_API unsigned long long wt9011_monotonic_ns() {
+    return wt9011::monotonic_ns();
+}
+
+WT9011_API wt9011_session* wt9011_session_create(const char* address) {
+    if (!address) {
+        return nullptr;
+    }
+    try {
+        if (wt9011::is_sim_address(address)) {
+            return wt9011::open_sim_session(address);
+        }
+        // Before wt9011_init or after wt9011_cleanup there is no interpreter
+        // to take the GIL from
+        if (!Py_IsInitialized()) {
+            return nullptr;
+        }
+        py::gil_scoped_acquire acquire;
+        if (!ble_manager_class) {
+            return nullptr;
+        }
+        auto session = std::make_shared<wt9011_session>(address);
+        session->manager = ble_manager_class();
+        session->worker = wt9011::dispatcher().assign();
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        sessions.push_back(session);
+        return session.get();
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+WT9011_API wt9011_op* wt9011_session_connect_async(wt9011_session* session) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return nullptr;
+    }
+    if (owned->source) {
+        return new wt9011_op{ py::object(), true, true };
+    }
+    if (!Py_IsInitialized()) {
+        return nullptr;
+    }
+    try {
+        py::gil_scoped_acquire acquire;
+        if (!owned->manager) {
+            return nullptr;
+        }
+        return new wt9011_op{ wt9011::io_loop().submit(owned->manager.attr("connect")(owned->address)) };
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+WT9011_API wt9011_session* wt9011_open(const char* address) {
+    wt9011_session* session = wt9011_session_create(address);
+    if (!session) {
+        return nullptr;
+    }
+    wt9011_op* op = wt9011_session_connect_async(session);
+    bool connected = op && wt9011_op_wait(op, -1) == 1;
+    wt9011_op_free(op);
+    if (!connected) {
+        wt9011_close(session);
+        return nullptr;
+    }
+    return session;
+}
+
+WT9011_API bool wt9011_close(wt9011_session* session) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return false;
+    }
+    bool ok = false;
+    if (owned->source) {
+        ok = shutdown_session(owned.get());
+    } else {
+        quiesce_session(owned.get());
+        try {
+            py::gil_scoped_acquire acquire;
+            ok = shutdown_session(owned.get());
+        } catch (const std::exception&) {
+            ok = false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(sessions_mutex);
+    sessions.erase(std::remove(sessions.begin(), sessions.end(), owned), sessions.end());
+    return ok;
+}
+
+WT9011_API wt9011_op* wt9011_session_disconnect_async(wt9011_session* session) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return nullptr;
+    }
+    wt9011_op* op = nullptr;
+    if (owned->source) {
+        op = new wt9011_op{ py::object(), true, shutdown_session(owned.get()) };
+    } else {
+        if (!Py_IsInitialized()) {
+            return nullptr;
+        }
+        quiesce_session(owned.get());
+        try {
+            py::gil_scoped_acquire acquire;
+            const bool stopped = stop_session(owned.get());
+            if (owned->manager) {
+                // The submitted coroutine keeps the manager alive until it finishes
+                op = new wt9011_op{ wt9011::io_loop().submit(owned->manager.attr("disconnect")()) };
+                owned->manager = py::object();
+            } else {
+                op = new wt9011_op{ py::object(), true, stopped };
+            }
+        } catch (const std::exception&) {
+            op = nullptr;
+        }
+    }
+    std::lock_guard<std::mutex> lock(sessions_mutex);
+    sessions.erase(std::remove(sessions.begin(), sessions.end(), owned), sessions.end());
+    return op;
+}
+
+WT9011_API bool wt9011_session_receive(wt9011_session* session, SessionSampleCallback callback, void* user) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return false;
+    }
+    if (owned->source) {
+        // Restart delivery so the callback never changes under a running source
+        owned->source->stop();
+        owned->callback = callback;
+        owned->user = user;
+        owned->assembler.reset();
+        return owned->source->start(*owned);
+    }
+    if (wt9011::Dispatcher::on_worker_thread()) {
+        return false; // From inside a callback; the worker holds dispatch_mutex
+    }
+    {
+        // Before the GIL: a running callback may be waiting for it
+        std::lock_guard<std::mutex> lock(owned->dispatch_mutex);
+        owned->callback = callback;
+        owned->user = user;
+        owned->assembler.reset();
+    }
+    try {
+        py::gil_scoped_acquire acquire;
+        if (!owned->manager) {
+            return false;
+        }
+        // The handler keeps the session alive for as long as bleak holds it.
+        // It runs on the I/O loop with the GIL held, so it only copies the
+        // bytes; a slow consumer delays its own worker, never the radio.
+        py::cpp_function handler([owned](py::object data) {
+            const std::uint64_t arrival_ns = wt9011::monotonic_ns();
+            const std::uint8_t* buffer = nullptr;
+            std::size_t length = 0;
+            if (wt9011::get_notification_buffer(data, buffer, length)) {
+                enqueue_notification(owned, buffer, length, arrival_ns);
+            }
+        });
+        wt9011::io_loop().run(owned->manager.attr("receive")(handler));
+        return true;
+    } catch (const std::exception&) {
+        wt9011::set_session_callback(*owned, nullptr, nullptr);
+        return false;
+    }
+}
+
+WT9011_API size_t wt9011_session_poll(wt9011_session* session, SensorData* out, size_t max) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned || !out) {
+        return 0;
+    }
+    return owned->queue.consume(max, [out](std::size_t i, const SensorSample& sample) { out[i] = sample.data; });
+}
+
+WT9011_API size_t wt9011_session_poll_samples(wt9011_session* session, SensorSample* out, size_t max) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned || !out) {
+        return 0;
+    }
+    return owned->queue.pop(out, max);
+}
+
+WT9011_API wt9011_op* wt9011_session_send_async(wt9011_session* session, const unsigned char* command, int length) {
+    if (!command || length <= 0) {
+        return nullptr;
+    }
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return nullptr;
+    }
+    if (owned->source) {
+        return new wt9011_op{ py::object(), true, owned->source->write(command, static_cast<std::size_t>(length)) };
+    }
+    try {
+        py::gil_scoped_acquire acquire;
+        if (!owned->manager) {
+            return nullptr;
+        }
+        py::bytes payload(reinterpret_cast<const char*>(command), static_cast<size_t>(length));
+        return new wt9011_op{ wt9011::io_loop().submit(owned->manager.attr("send")(payload)) };
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+WT9011_API bool wt9011_session_send(wt9011_session* session, const unsigned char* command, int length) {
+    wt9011_op* op = wt9011_session_send_async(session, command, length);
+    bool ok = op && wt9011_op_wait(op, -1) == 1;
+    wt9011_op_free(op);
+    return ok;
+}
+
+WT9011_API wt9011_op* wt9011_session_write_register_async(wt9011_session* session, unsigned char reg,
+                                                          unsigned short value) {
+    const wt9011::Command command = wt9011::encode_command(reg, value);
+    return wt9011_session_send_async(session, command.bytes, static_cast<int>(wt9011::kCommandSize));
+}
+
+WT9011_API bool wt9011_session_write_register(wt9011_session* session, unsigned char reg, unsigned short value) {
+    const wt9011::Command command = wt9011::encode_command(reg, value);
+    return wt9011_session_send(session, command.bytes, static_cast<int>(wt9011::kCommandSize));
+}
+
+WT9011_API wt9011_op* wt9011_session_read_register_async(wt9011_session* session, unsigned char reg, int timeout_ms) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return nullptr;
+    }
+    // Register before sending so a fast reply cannot slip past
+    std::shared_ptr<wt9011::RegisterRead> read = owned->reads.start(reg, timeout_ms);
+    const wt9011::Command command = wt9011::command_read_register(reg);
+    wt9011_op* sent = wt9011_session_send_async(session, command.bytes, static_cast<int>(wt9011::kCommandSize));
+    if (!sent) {
+        owned->reads.cancel(read);
+        return nullptr;
+    }
+    // A failed write shows up as the read timing out
+    wt9011_op_free(sent);
+    wt9011_op* op = new wt9011_op{ py::object(), true, false };
+    op->read = std::move(read);
+    return op;
+}
+
+WT9011_API bool wt9011_session_read_register(wt9011_session* session, unsigned char reg, unsigned short* value,
+                                             int timeout_ms) {
+    wt9011_op* op = wt9011_session_read_register_async(session, reg, timeout_ms);
+    bool ok = op && wt9011_op_wait(op, -1) == 1 && (!value || wt9011_op_registers(op, value, 1));
+    wt9011_op_free(op);
+    return ok;
+}
+
+WT9011_API size_t wt9011_read_config(wt9011_session* const* sessions, size_t count, const unsigned char* regs,
+                                     size_t reg_count, unsigned short* out, bool* ok, int timeout_ms) {
+    if (!sessions || !regs || !out) {
+        return 0;
+    }
+    std::vector<wt9011_op*> ops(count * reg_count, nullptr);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t j = 0; j < reg_count; ++j) {
+            ops[i * reg_count + j] = wt9011_session_read_register_async(sessions[i], regs[j], timeout_ms);
+        }
+    }
+    // Every read carries its own deadline, so waiting in turn takes no longer
+    // than the slowest one
+    std::size_t succeeded = 0;
+    for (std::size_t k = 0; k < ops.size(); ++k) {
+        const bool read = ops[k] && wt9011_op_wait(ops[k], -1) == 1 && wt9011_op_registers(ops[k], &out[k], 1);
+        if (ok) {
+            ok[k] = read;
+        }
+        succeeded += read ? 1 : 0;
+        wt9011_op_free(ops[k]);
+    }
+    return succeeded;
+}
+
+WT9011_API bool wt9011_session_set_filters(wt9011_session* session, const FilterStageConfig* stages, size_t count,
+                                           float sample_rate_hz) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return false;
+    }
+    if (!stages || count == 0) {
+        std::atomic_store(&owned->filters, std::shared_ptr<wt9011::FilterChain>());
+        return true;
+    }
+    try {
+        std::shared_ptr<wt9011::FilterChain> chain = wt9011::FilterChain::create(stages, count, sample_rate_hz);
+        if (!chain) {
+            return false;
+        }
+        std::atomic_store(&owned->filters, std::move(chain));
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+WT9011_API bool wt9011_session_set_windows(wt9011_session* session, const double* seconds, size_t count,
+                                           double max_rate_hz) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return false;
+    }
+    if (!seconds || count == 0) {
+        std::atomic_store(&owned->windows, std::shared_ptr<wt9011::WindowSet>());
+        return true;
+    }
+    const double rate = max_rate_hz > 0.0 ? max_rate_hz : wt9011::kDefaultWindowRateHz;
+    try {
+        auto set = std::make_shared<wt9011::WindowSet>();
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!(seconds[i] > 0.0)) {
+                return false;
+            }
+            const std::size_t capacity = static_cast<std::size_t>(std::ceil(seconds[i] * rate)) + 1;
+            set->windows.push_back(std::make_unique<wt9011::SlidingWindow>(
+                static_cast<std::uint64_t>(seconds[i] * 1e9), capacity));
+        }
+        std::atomic_store(&owned->windows, std::move(set));
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+WT9011_API bool wt9011_session_window_stats(wt9011_session* session, size_t window, WindowStats* out) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned || !out) {
+        return false;
+    }
+    std::shared_ptr<wt9011::WindowSet> set = std::atomic_load(&owned->windows);
+    if (!set || window >= set->windows.size()) {
+        return false;
+    }
+    set->windows[window]->query(*out);
+    return true;
+}
+
+WT9011_API bool wt9011_session_set_spectrum(wt9011_session* session, const SpectrumConfig* config,
+                                            SessionSpectrumCallback callback, void* user) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return false;
+    }
+    if (!config) {
+        std::atomic_store(&owned->spectrum, std::shared_ptr<wt9011::SpectrumStage>());
+        return true;
+    }
+    try {
+        std::unique_ptr<wt9011::SpectrumAnalyzer> analyzer = wt9011::SpectrumAnalyzer::create(*config);
+        if (!analyzer) {
+            return false;
+        }
+        auto stage = std::make_shared<wt9011::SpectrumStage>();
+        stage->analyzer = std::move(analyzer);
+        stage->callback = callback;
+        stage->user = user;
+        std::atomic_store(&owned->spectrum, std::move(stage));
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+WT9011_API bool wt9011_session_spectrum(wt9011_session* session, SpectrumReport* out) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned || !out) {
+        return false;
+    }
+    std::shared_ptr<wt9011::SpectrumStage> stage = std::atomic_load(&owned->spectrum);
+    return stage && stage->analyzer->latest(*out);
+}
+
+WT9011_API size_t wt9011_session_spectrum_bins(wt9011_session* session, unsigned channel, float* out, size_t max) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return 0;
+    }
+    std::shared_ptr<wt9011::SpectrumStage> stage = std::atomic_load(&owned->spectrum);
+    return stage ? stage->analyzer->latest_bins(channel, out, max) : 0;
+}
+
+WT9011_API bool wt9011_session_set_fusion(wt9011_session* session, const FusionConfig* config,
+                                          SessionFusedCallback callback, void* user) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return false;
+    }
+    if (!config) {
+        std::atomic_store(&owned->fusion, std::shared_ptr<wt9011::FusionStage>());
+        return true;
+    }
+    if (config->algorithm != WT9011_FUSION_MADGWICK && config->algorithm != WT9011_FUSION_MAHONY) {
+        return false;
+    }
+    try {
+        std::atomic_store(&owned->fusion, std::make_shared<wt9011::FusionStage>(*config, callback, user));
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+WT9011_API bool wt9011_session_record(wt9011_session* session, wt9011_recorder* recorder) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return false;
+    }
+    if (!recorder) {
+        std::atomic_store(&owned->recording, std::shared_ptr<const wt9011::RecorderLink>());
+        return true;
+    }
+    if (!recorder->recorder->is_open()) {
+        return false;
+    }
+    try {
+        auto link = std::make_shared<wt9011::RecorderLink>();
+        link->recorder = recorder->recorder;
+        link->sensor_id = recorder->recorder->add_sensor(owned->address);
+        std::atomic_store(&owned->recording, std::shared_ptr<const wt9011::RecorderLink>(std::move(link)));
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+WT9011_API bool wt9011_session_capture(wt9011_session* session, const char* path) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    if (!owned) {
+        return false;
+    }
+    std::shared_ptr<wt9011::CaptureWriter> previous =
+        std::atomic_exchange(&owned->capture, std::shared_ptr<wt9011::CaptureWriter>());
+    bool ok = !previous || previous->close();
+    if (!path) {
+        return ok;
+    }
+    try {
+        auto writer = std::make_shared<wt9011::CaptureWriter>();
+        if (!writer->open(path)) {
+            return false;
+        }
+        std::atomic_store(&owned->capture, std::move(writer));
+        return ok;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+WT9011_API bool wt9011_replay_done(wt9011_session* session) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    return owned && owned->source && owned->source->finished();
+}
+
+WT9011_API unsigned long long wt9011_session_dropped_samples(wt9011_session* session) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    return owned ? owned->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+WT9011_API unsigned long long wt9011_session_discarded_bytes(wt9011_session* session) {
+    std::shared_ptr<wt9011_session> owned = find_session(session);
+    return owned ? owned->assembler.discarded_bytes() : 0;
+}
@@ -0,0 +1,104 @@
+#ifndef WT9011_SESSION_H
+#define WT9011_SESSION_H
+
+#include <pybind11/pybind11.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "wt9011_api.h"
+#include "wt9011_types.h"
+#include "wt9011_assembler.h"
+#include "wt9011_ring.h"
+#include "wt9011_recorder.h"
+#include "wt9011_capture.h"
+#include "wt9011_dispatch.h"
+#include "wt9011_filters.h"
+#include "wt9011_fusion.h"
+#include "wt9011_registers.h"
+#include "wt9011_source.h"
+#include "wt9011_spectrum.h"
+#include "wt9011_window_stats.h"
+
+namespace py = pybind11;
+
+namespace wt9011 {
+
+// Recorder a session streams into, with the session's sensor id in that file
+struct RecorderLink {
+    std::shared_ptr<Recorder> recorder;
+    std::uint32_t sensor_id;
+};
+
+} // namespace wt9011
+
+// State of one sensor connection.
+//
+// Sessions are owned by the registry in wt9011_session.cpp through shared_ptr;
+// the notification handler registered with bleak holds another reference, so
+// a notification racing with wt9011_close never touches freed memory.
+// Python members must only be touched with the GIL held. A session has either
+// a BLEManager (`manager`) or a native `source`; source sessions never use Python.
+// BLE notifications are copied into `packets` under the GIL and delivered by a
+// dispatch worker (wt9011_dispatch.h); sources deliver on their own thread.
+struct wt9011_session {
+    explicit wt9011_session(std::string address);
+
+    // Native receive path, runs for every notification on the delivering thread
+    // (the I/O loop, or the source's thread); `timestamp_ns` is the monotonic
+    // arrival time of the notification
+    void on_notification(const std::uint8_t* data, std::size_t length, std::uint64_t timestamp_ns);
+    // Dispatch worker: deliver up to `max` queued packets; true if more are left
+    bool drain_packets(std::size_t max);
+
+    const std::string address;
+    py::object manager; // BLEManager instance of this connection
+    std::unique_ptr<wt9011::NotificationSource> source;
+
+    wt9011::FrameAssembler assembler;
+    wt9011::SpscRing<SensorSample, 4096> queue;
+    std::atomic<unsigned long long> dropped{0};
+    std::uint64_t next_sequence = 0; // Delivering thread only
+    wt9011::RegisterReads reads;
+    std::shared_ptr<const wt9011::RecorderLink> recording; // std::atomic_load / std::atomic_store only
+    std::shared_ptr<wt9011::CaptureWriter> capture;        // std::atomic_load / std::atomic_store only
+    std::shared_ptr<wt9011::FilterChain> filters;          // std::atomic_load / std::atomic_store only
+    std::shared_ptr<wt9011::FusionStage> fusion;           // std::atomic_load / std::atomic_store only
+    std::shared_ptr<wt9011::WindowSet> windows;            // std::atomic_load / std::atomic_store only
+    std::shared_ptr<wt9011::SpectrumStage> spectrum;       // std::atomic_load / std::atomic_store only
+
+    wt9011::SpscRing<wt9011::RawPacket, 256> packets; // I/O loop -> dispatch worker
+    std::atomic<bool> scheduled{false};                // Queued on or owned by the worker
+    std::size_t worker = 0;
+    // Held by the worker while delivering; taking it waits out a running callback
+    std::mutex dispatch_mutex;
+
+    // Set before notifications start, or under dispatch_mutex; read on the
+    // delivering thread
+    SessionSampleCallback callback = nullptr;
+    void* user = nullptr;
+    std::atomic<bool> closed{false};
+};
+
+namespace wt9011 {
+
+// Python class each new session instantiates (BLEManager); set by wt9011_init
+void set_ble_manager_class(py::object cls);
+// Disconnect and free every open session, then drop the class. GIL must be held.
+void close_all_sessions();
+
+// Replace the callback of a BLE session without the GIL, waiting out one that
+// is running on the dispatch worker (unless called from inside it)
+void set_session_callback(wt9011_session& session, SessionSampleCallback callback, void* user);
+
+// Register a session fed by a native source instead of BLE
+wt9011_session* open_source_session(const std::string& address, std::unique_ptr<NotificationSource> source);
+
+// Borrow the raw buffer of a bytes/bytearray notification payload
+bool get_notification_buffer(py::handle data, const std::uint8_t*& buffer, std::size_t& length);
+
+} // namespace wt9011
+
+#endif // WT9011_SESSION_H
@@ -0,0 +1,317 @@
+#include "wt9011_sim.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include "wt9011_clock.h"
+#include "wt9011_commands.h"
+#include "wt9011_decoder.h"
+#include "wt9011_session.h"
+
+namespace wt9011 {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kDegToRad = kPi / 180.0;
+constexpr double kMaxRateHz = 100000.0;
+
+std::chrono::steady_clock::time_point to_time_point(std::uint64_t ns) {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+} // namespace
+
+bool parse_sim_options(const char* text, SimOptions& out) {
+    SimOptions options = out;
+    const char* p = text ? text : "";
+    while (*p) {
+        const char* end = std::strchr(p, ',');
+        const std::string item(p, end ? static_cast<std::size_t>(end - p) : std::strlen(p));
+        p = end ? end + 1 : p + item.size();
+        if (item.empty()) {
+            continue;
+        }
+        const std::size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            return false;
+        }
+        const std::string key = item.substr(0, eq);
+        const char* value = item.c_str() + eq + 1;
+        char* parsed_end = nullptr;
+        const double number = std::strtod(value, &parsed_end);
+        if (parsed_end == value || *parsed_end != '\0' || number < 0.0) {
+            return false;
+        }
+        if (key == "devices") {
+            options.devices = static_cast<unsigned>(number);
+        } else if (key == "rate") {
+            options.rate_hz = number;
+        } else if (key == "jitter_us") {
+            options.jitter_us = number;
+        } else if (key == "loss") {
+            options.loss = number;
+        } else if (key == "seed") {
+            options.seed = static_cast<unsigned>(number);
+        } else {
+            return false;
+        }
+    }
+    if (options.rate_hz <= 0.0 || options.rate_hz > kMaxRateHz || options.loss > 1.0) {
+        return false;
+    }
+    out = options;
+    return true;
+}
+
+SimOptions sim_options_from_env() {
+    SimOptions options;
+    parse_sim_options(std::getenv(kSimEnvironment), options);
+    return options;
+}
+
+bool is_sim_address(const std::string& address) {
+    return address.compare(0, sizeof(kSimAddressPrefix) - 1, kSimAddressPrefix) == 0;
+}
+
+std::vector<DeviceInfo> sim_devices() {
+    std::vector<DeviceInfo> devices;
+    if (!std::getenv(kSimEnvironment)) {
+        return devices;
+    }
+    const SimOptions options = sim_options_from_env();
+    for (unsigned i = 0; i < options.devices; ++i) {
+        devices.push_back({ "WT9011 Simulator " + std::to_string(i), kSimAddressPrefix + std::to_string(i) });
+    }
+    return devices;
+}
+
+SimSource::SimSource(const SimOptions& options, unsigned device_index)
+    : options_(options), device_index_(device_index), rate_hz_(options.rate_hz) {
+    reset_registers();
+}
+
+SimSource::~SimSource() {
+    stop();
+}
+
+bool SimSource::start(wt9011_session& session) {
+    if (thread_.joinable()) {
+        return false;
+    }
+    stopping_ = false;
+    retimed_ = false;
+    reads_.clear();
+    thread_ = std::thread(&SimSource::run, this, std::ref(session));
+    return true;
+}
+
+void SimSource::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool SimSource::write(const std::uint8_t* data, std::size_t length) {
+    std::uint8_t reg = 0;
+    std::uint16_t value = 0;
+    if (!decode_command(data, length, reg, value)) {
+        return false;
+    }
+    switch (reg) {
+    case kRegReturnRate:
+        if (value == 0 || value > kMaxRateHz) {
+            return false;
+        }
+        rate_hz_.store(static_cast<double>(value), std::memory_order_relaxed);
+        break;
+    case kRegSleep:
+        asleep_.store(value == 0, std::memory_order_relaxed);
+        break;
+    case kRegAccelEnable:
+        accel_enabled_.store(value != 0, std::memory_order_relaxed);
+        break;
+    case kRegGyroEnable:
+        gyro_enabled_.store(value != 0, std::memory_order_relaxed);
+        break;
+    case kRegZeroing:
+        zero_requested_.store(true, std::memory_order_relaxed);
+        break;
+    case kRegFactoryReset:
+        rate_hz_.store(options_.rate_hz, std::memory_order_relaxed);
+        accel_enabled_.store(true, std::memory_order_relaxed);
+        gyro_enabled_.store(true, std::memory_order_relaxed);
+        reset_requested_.store(true, std::memory_order_relaxed);
+        break;
+    case kRegReadRegister:
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            reads_.push_back(static_cast<std::uint8_t>(value));
+        }
+        cv_.notify_all();
+        return true;
+    case kRegSave:
+    case kRegCalibration:
+    case kRegUnlock:
+        break;
+    default:
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (reg == kRegFactoryReset) {
+            reset_registers();
+        } else {
+            registers_[reg] = value;
+        }
+    }
+    if (reg == kRegReturnRate || reg == kRegSleep || reg == kRegFactoryReset) {
+        // Take effect now instead of after the old period
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            retimed_ = true;
+        }
+        cv_.notify_all();
+    }
+    return true;
+}
+
+// mutex_ held, or not shared yet
+void SimSource::reset_registers() {
+    std::fill(std::begin(registers_), std::end(registers_), std::uint16_t{0});
+    registers_[kRegSleep] = 1;
+    registers_[kRegAccelEnable] = 1;
+    registers_[kRegGyroEnable] = 1;
+    registers_[kRegReturnRate] = static_cast<std::uint16_t>(std::min(options_.rate_hz, 65535.0));
+}
+
+// Reply to every queued read; called with `lock` held, returns with it held
+void SimSource::answer_reads(wt9011_session& session, std::unique_lock<std::mutex>& lock) {
+    std::uint8_t frame[kFrameSize];
+    std::uint16_t values[kRegisterReplyValues];
+    while (!reads_.empty()) {
+        const std::uint8_t reg = reads_.front();
+        reads_.pop_front();
+        for (std::size_t i = 0; i < kRegisterReplyValues; ++i) {
+            values[i] = registers_[(reg + i) & 0xFF];
+        }
+        encode_register_frame(reg, values, frame);
+        lock.unlock();
+        session.on_notification(frame, kFrameSize, monotonic_ns());
+        lock.lock();
+    }
+}
+
+// Smooth rotation with gravity in the accelerometer and a little vibration
+void SimSource::synthesize(double t, SensorData& out) {
+    const double phase = device_index_ * 0.7;
+    const double roll = 30.0 * std::sin(2.0 * kPi * 0.2 * t + phase);
+    const double pitch = 20.0 * std::sin(2.0 * kPi * 0.13 * t + phase);
+    const double raw_yaw = 36.0 * t;
+    if (zero_requested_.exchange(false, std::memory_order_relaxed)) {
+        yaw_offset_ = raw_yaw;
+    }
+    if (reset_requested_.exchange(false, std::memory_order_relaxed)) {
+        yaw_offset_ = 0.0;
+    }
+    double yaw = std::fmod(raw_yaw - yaw_offset_ + 180.0, 360.0);
+    yaw = (yaw < 0.0 ? yaw + 360.0 : yaw) - 180.0;
+
+    const double vibration = 0.02 * std::sin(2.0 * kPi * 7.0 * t);
+    const double r = roll * kDegToRad;
+    const double p = pitch * kDegToRad;
+    if (accel_enabled_.load(std::memory_order_relaxed)) {
+        out.accel = { static_cast<float>(-std::sin(p) + vibration),
+                      static_cast<float>(std::sin(r) * std::cos(p)),
+                      static_cast<float>(std::cos(r) * std::cos(p) + vibration) };
+    } else {
+        out.accel = { 0.0f, 0.0f, 0.0f };
+    }
+    if (gyro_enabled_.load(std::memory_order_relaxed)) {
+        out.gyro = { static_cast<float>(30.0 * 2.0 * kPi * 0.2 * std::cos(2.0 * kPi * 0.2 * t + phase)),
+                     static_cast<float>(20.0 * 2.0 * kPi * 0.13 * std::cos(2.0 * kPi * 0.13 * t + phase)),
+                     36.0f };
+    } else {
+        out.gyro = { 0.0f, 0.0f, 0.0f };
+    }
+    out.angle = { static_cast<float>(roll), static_cast<float>(pitch), static_cast<float>(yaw) };
+}
+
+void SimSource::run(wt9011_session& session) {
+    std::mt19937 rng(options_.seed * 7919u + device_index_);
+    std::uniform_real_distribution<double> jitter(-options_.jitter_us * 1000.0, options_.jitter_us * 1000.0);
+    std::bernoulli_distribution lost(options_.loss);
+
+    const std::uint64_t start = monotonic_ns();
+    std::uint64_t next = start;
+    std::uint8_t frame[kFrameSize];
+    SensorData data;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        const std::uint64_t period = static_cast<std::uint64_t>(1e9 / rate_hz_.load(std::memory_order_relaxed));
+        next += period;
+        const std::uint64_t now = monotonic_ns();
+        if (now > next + 1000000000ull) {
+            next = now; // Stalled for over a second: resume instead of bursting
+        }
+        const double offset = options_.jitter_us > 0.0 ? jitter(rng) : 0.0;
+        const std::uint64_t due = offset < 0.0 && static_cast<std::uint64_t>(-offset) > next
+            ? next : static_cast<std::uint64_t>(static_cast<double>(next) + offset);
+        // Register reads are answered as they come, not at the next sample
+        while (cv_.wait_until(lock, to_time_point(due), [this] { return stopping_ || retimed_ || !reads_.empty(); })
+               && !stopping_ && !retimed_) {
+            answer_reads(session, lock);
+        }
+        if (stopping_) {
+            break;
+        }
+        if (retimed_) {
+            retimed_ = false;
+            next = monotonic_ns();
+            continue;
+        }
+        if (asleep_.load(std::memory_order_relaxed) || (options_.loss > 0.0 && lost(rng))) {
+            continue;
+        }
+        lock.unlock();
+        synthesize(static_cast<double>(next - start) * 1e-9, data);
+        encode_frame(data, frame);
+        session.on_notification(frame, kFrameSize, monotonic_ns());
+        sent_.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+}
+
+wt9011_session* open_sim_session(const std::string& address) {
+    unsigned index = 0;
+    const std::string suffix = address.substr(sizeof(kSimAddressPrefix) - 1);
+    if (!suffix.empty()) {
+        index = static_cast<unsigned>(std::strtoul(suffix.c_str(), nullptr, 10));
+    }
+    return open_source_session(address, std::make_unique<SimSource>(sim_options_from_env(), index));
+}
+
+} // namespace wt9011
+
+WT9011_API wt9011_session* wt9011_sim_open(const char* options, unsigned device_index) {
+    wt9011::SimOptions parsed;
+    if (!wt9011::parse_sim_options(options, parsed)) {
+        return nullptr;
+    }
+    try {
+        return wt9011::open_source_session(wt9011::kSimAddressPrefix + std::to_string(device_index),
+                                           std::make_unique<wt9011::SimSource>(parsed, device_index));
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef WT9011_SIM_H
+#define WT9011_SIM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "wt9011_types.h"
+#include "wt9011_source.h"
+
+namespace wt9011 {
+
+// Simulated sensors. Addresses starting with "SIM:" connect to a simulator
+// instead of BLE; WT9011_SIM ("devices=4,rate=500,jitter_us=200,loss=0.01,seed=1")
+// makes them show up in scans and sets their parameters.
+struct SimOptions {
+    unsigned devices = 1;
+    double rate_hz = 100.0;  // Initial rate; the rate command changes it
+    double jitter_us = 0.0;  // Uniform jitter of each notification's send time
+    double loss = 0.0;       // Probability that a notification is lost
+    unsigned seed = 1;
+};
+
+constexpr char kSimAddressPrefix[] = "SIM:";
+constexpr char kSimEnvironment[] = "WT9011_SIM";
+
+// Parse "key=value,..."; false on unknown keys or bad values
+bool parse_sim_options(const char* text, SimOptions& out);
+// Options from WT9011_SIM, defaults if unset or invalid
+SimOptions sim_options_from_env();
+bool is_sim_address(const std::string& address);
+// Devices a scan reports: empty unless WT9011_SIM is set
+std::vector<DeviceInfo> sim_devices();
+// Register a session for a "SIM:<index>" address, configured from WT9011_SIM
+wt9011_session* open_sim_session(const std::string& address);
+
+// One simulated WT9011: emits 0x55 0x61 frames of smooth synthetic motion and
+// reacts to the WT9011Commands writes (rate, sleep/wakeup, sensor enables,
+// zeroing, factory reset) and answers register reads with 0x55 0x71 frames.
+// Accepts 4-byte FF AA reg val and 5-byte FF AA reg lo hi commands.
+class SimSource : public NotificationSource {
+public:
+    SimSource(const SimOptions& options, unsigned device_index);
+    ~SimSource() override;
+
+    bool start(wt9011_session& session) override;
+    void stop() override;
+    bool write(const std::uint8_t* data, std::size_t length) override;
+
+    double rate_hz() const { return rate_hz_.load(std::memory_order_relaxed); }
+    std::uint64_t sent() const { return sent_.load(std::memory_order_relaxed); }
+
+private:
+    void run(wt9011_session& session);
+    void synthesize(double t, SensorData& out);
+    void reset_registers();
+    void answer_reads(wt9011_session& session, std::unique_lock<std::mutex>& lock);
+
+    const SimOptions options_;
+    const unsigned device_index_;
+    std::atomic<double> rate_hz_;
+    std::atomic<bool> asleep_{false};
+    std::atomic<bool> accel_enabled_{true};
+    std::atomic<bool> gyro_enabled_{true};
+    std::atomic<bool> zero_requested_{false};
+    std::atomic<bool> reset_requested_{false};
+    std::atomic<std::uint64_t> sent_{0};
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    bool retimed_ = false;    // Rate or sleep state changed while waiting
+    std::uint16_t registers_[256] = {}; // Last value written to each register
+    std::deque<std::uint8_t> reads_;    // Register reads not answered yet
+    double yaw_offset_ = 0.0; // Simulator thread only
+};
+
+} // namespace wt9011
+
+#endif // WT9011_SIM_H
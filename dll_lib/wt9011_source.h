@@ -0,0 +1,30 @@
+#ifndef WT9011_SOURCE_H
+#define WT9011_SOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct wt9011_session;
+
+namespace wt9011 {
+
+// Native producer of notifications that stands in for a BLE connection
+// (capture replay, simulator). Sessions backed by a source never touch Python.
+class NotificationSource {
+public:
+    virtual ~NotificationSource() = default;
+
+    // Begin delivering notifications to session.on_notification from the
+    // source's own thread
+    virtual bool start(wt9011_session& session) = 0;
+    // Stop delivering; must not return while a delivery is in progress
+    virtual void stop() = 0;
+    // Command written to the device
+    virtual bool write(const std::uint8_t* data, std::size_t length) = 0;
+    // True once a finite source has delivered everything
+    virtual bool finished() const { return false; }
+};
+
+} // namespace wt9011
+
+#endif // WT9011_SOURCE_H
@@ -0,0 +1,232 @@
+#include "wt9011_spectrum.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace wt9011 {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr float kTinyAmplitude = 1e-30f;
+
+bool is_power_of_two(unsigned n) {
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+} // namespace
+
+FftPlan::FftPlan(std::size_t n)
+    : n_(n), half_(n / 2), bitrev_(half_), twiddle_re_(half_ / 2), twiddle_im_(half_ / 2), split_re_(half_ + 1),
+      split_im_(half_ + 1) {
+    unsigned bits = 0;
+    while ((std::size_t{1} << bits) < half_) {
+        ++bits;
+    }
+    for (std::size_t i = 0; i < half_; ++i) {
+        std::uint32_t r = 0;
+        for (unsigned b = 0; b < bits; ++b) {
+            r |= ((i >> b) & 1u) << (bits - 1 - b);
+        }
+        bitrev_[i] = r;
+    }
+    for (std::size_t j = 0; j < half_ / 2; ++j) {
+        twiddle_re_[j] = static_cast<float>(std::cos(-2.0 * kPi * j / half_));
+        twiddle_im_[j] = static_cast<float>(std::sin(-2.0 * kPi * j / half_));
+    }
+    for (std::size_t k = 0; k <= half_; ++k) {
+        split_re_[k] = static_cast<float>(std::cos(-2.0 * kPi * k / n_));
+        split_im_[k] = static_cast<float>(std::sin(-2.0 * kPi * k / n_));
+    }
+}
+
+void FftPlan::forward(const float* in, float* re, float* im, float* work_re, float* work_im) const {
+    // Even samples as the real part, odd ones as the imaginary part
+    for (std::size_t i = 0; i < half_; ++i) {
+        work_re[bitrev_[i]] = in[2 * i];
+        work_im[bitrev_[i]] = in[2 * i + 1];
+    }
+    for (std::size_t size = 2; size <= half_; size *= 2) {
+        const std::size_t span = size / 2;
+        const std::size_t step = half_ / size;
+        for (std::size_t start = 0; start < half_; start += size) {
+            for (std::size_t j = 0; j < span; ++j) {
+                const float wr = twiddle_re_[j * step];
+                const float wi = twiddle_im_[j * step];
+                const std::size_t a = start + j;
+                const std::size_t b = a + span;
+                const float tr = wr * work_re[b] - wi * work_im[b];
+                const float ti = wr * work_im[b] + wi * work_re[b];
+                work_re[b] = work_re[a] - tr;
+                work_im[b] = work_im[a] - ti;
+                work_re[a] += tr;
+                work_im[a] += ti;
+            }
+        }
+    }
+    // Split the packed transform into the spectrum of the real sequence:
+    // X[k] = E[k] + exp(-2 pi i k / n) O[k]
+    for (std::size_t k = 0; k <= half_; ++k) {
+        const std::size_t i = k % half_;
+        const std::size_t j = (half_ - k) % half_;
+        const float zr = work_re[i], zi = work_im[i];
+        const float cr = work_re[j], ci = -work_im[j];
+        const float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+        const float or_ = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);
+        re[k] = er + split_re_[k] * or_ - split_im_[k] * oi;
+        im[k] = ei + split_re_[k] * oi + split_im_[k] * or_;
+    }
+}
+
+std::unique_ptr<SpectrumAnalyzer> SpectrumAnalyzer::create(const SpectrumConfig& config) {
+    if (!is_power_of_two(config.fft_size) || config.fft_size < kMinFftSize || config.fft_size > kMaxFftSize ||
+        config.hop > config.fft_size || !(config.sample_rate_hz > 0.0f) ||
+        config.band_count > WT9011_SPECTRUM_MAX_BANDS ||
+        (config.channels & ~static_cast<unsigned>(WT9011_CHANNEL_ALL)) ||
+        (config.window != WT9011_WINDOW_HANN && config.window != WT9011_WINDOW_BLACKMAN)) {
+        return nullptr;
+    }
+    for (unsigned b = 0; b < config.band_count; ++b) {
+        if (!(config.band_edges_hz[b] < config.band_edges_hz[b + 1])) {
+            return nullptr;
+        }
+    }
+    return std::unique_ptr<SpectrumAnalyzer>(new SpectrumAnalyzer(config));
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer(const SpectrumConfig& config)
+    : config_([&config] {
+          SpectrumConfig c = config;
+          c.hop = c.hop ? c.hop : c.fft_size / 2;
+          c.channels = c.channels ? c.channels : static_cast<unsigned>(WT9011_CHANNEL_ALL);
+          return c;
+      }()),
+      n_(config.fft_size), bins_(n_ / 2 + 1), plan_(n_), window_(n_), history_(kSpectrumChannels * n_),
+      frame_(n_),
+      re_(bins_), im_(bins_), work_re_(n_ / 2), work_im_(n_ / 2), amplitude_(kSpectrumChannels * bins_),
+      published_amplitude_(kSpectrumChannels * bins_) {
+    double sum = 0.0, sum_squares = 0.0;
+    for (std::size_t i = 0; i < n_; ++i) {
+        const double x = 2.0 * kPi * i / n_; // Periodic windows
+        const double w = config_.window == WT9011_WINDOW_BLACKMAN
+            ? 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x)
+            : 0.5 - 0.5 * std::cos(x);
+        window_[i] = static_cast<float>(w);
+        sum += w;
+        sum_squares += w * w;
+    }
+    coherent_gain_ = static_cast<float>(sum);
+    power_scale_ = static_cast<float>(2.0 / (static_cast<double>(n_) * sum_squares));
+    report_.channels = config_.channels;
+}
+
+bool SpectrumAnalyzer::add(const SensorSample& sample) {
+    const SensorData& d = sample.data;
+    const float values[kSpectrumChannels] = { d.accel.x, d.accel.y, d.accel.z, d.gyro.x, d.gyro.y, d.gyro.z,
+                                              d.angle.roll, d.angle.pitch, d.angle.yaw };
+    for (std::size_t c = 0; c < kSpectrumChannels; ++c) {
+        history_[c * n_ + pos_] = values[c];
+    }
+    pos_ = pos_ + 1 == n_ ? 0 : pos_ + 1;
+    filled_ = std::min(filled_ + 1, n_);
+    ++since_;
+    if (filled_ < n_ || since_ < config_.hop) {
+        return false;
+    }
+    since_ = 0;
+    analyse(sample.timestamp_ns);
+    return true;
+}
+
+void SpectrumAnalyzer::analyse(std::uint64_t timestamp_ns) {
+    const float bin_hz = config_.sample_rate_hz / static_cast<float>(n_);
+    report_.timestamp_ns = timestamp_ns;
+    report_.index = analyses_++;
+    for (std::size_t c = 0; c < kSpectrumChannels; ++c) {
+        ChannelSpectrum& out = report_.channel[c];
+        out = ChannelSpectrum{};
+        float* amplitude = amplitude_.data() + c * bins_;
+        if (!((config_.channels >> c) & 1u)) {
+            std::fill(amplitude, amplitude + bins_, 0.0f);
+            continue;
+        }
+        // Oldest sample first: the ring starts at pos_
+        const float* ring = history_.data() + c * n_;
+        const std::size_t tail = n_ - pos_;
+        std::memcpy(frame_.data(), ring + pos_, tail * sizeof(float));
+        std::memcpy(frame_.data() + tail, ring, pos_ * sizeof(float));
+        double mean = 0.0;
+        for (std::size_t i = 0; i < n_; ++i) {
+            mean += frame_[i];
+        }
+        const float offset = static_cast<float>(mean / static_cast<double>(n_));
+        for (std::size_t i = 0; i < n_; ++i) {
+            frame_[i] = (frame_[i] - offset) * window_[i];
+        }
+        plan_.forward(frame_.data(), re_.data(), im_.data(), work_re_.data(), work_im_.data());
+
+        for (std::size_t k = 0; k < bins_; ++k) {
+            const float power = re_[k] * re_[k] + im_[k] * im_[k];
+            const bool edge = k == 0 || k == bins_ - 1; // DC and Nyquist appear once
+            amplitude[k] = (edge ? 1.0f : 2.0f) * std::sqrt(power) / coherent_gain_;
+            const float f = k * bin_hz;
+            for (unsigned b = 0; b < config_.band_count; ++b) {
+                if (f >= config_.band_edges_hz[b] && f < config_.band_edges_hz[b + 1]) {
+                    out.band_energy[b] += (edge ? 0.5f : 1.0f) * power_scale_ * power;
+                }
+            }
+        }
+
+        // Strongest local maxima, refined by a parabola through the log
+        // amplitudes of the neighbouring bins (exact for a Gaussian peak,
+        // close for Hann and Blackman)
+        for (std::size_t k = 1; k + 1 < bins_; ++k) {
+            if (!(amplitude[k] > amplitude[k - 1] && amplitude[k] >= amplitude[k + 1]) ||
+                amplitude[k] <= out.peaks[WT9011_SPECTRUM_PEAKS - 1].amplitude) {
+                continue;
+            }
+            const float a = std::log(std::max(amplitude[k - 1], kTinyAmplitude));
+            const float b = std::log(amplitude[k]);
+            const float e = std::log(std::max(amplitude[k + 1], kTinyAmplitude));
+            const float curvature = a - 2.0f * b + e;
+            const float delta = curvature < 0.0f ? 0.5f * (a - e) / curvature : 0.0f;
+            SpectrumPeak peak = { (static_cast<float>(k) + delta) * bin_hz,
+                                  std::exp(b - 0.25f * (a - e) * delta) };
+            std::size_t slot = WT9011_SPECTRUM_PEAKS - 1;
+            while (slot > 0 && out.peaks[slot - 1].amplitude < peak.amplitude) {
+                out.peaks[slot] = out.peaks[slot - 1];
+                --slot;
+            }
+            out.peaks[slot] = peak;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    published_report_ = report_;
+    published_amplitude_.swap(amplitude_);
+    published_ = true;
+}
+
+bool SpectrumAnalyzer::latest(SpectrumReport& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!published_) {
+        return false;
+    }
+    out = published_report_;
+    return true;
+}
+
+std::size_t SpectrumAnalyzer::latest_bins(std::size_t channel, float* out, std::size_t max) const {
+    if (channel >= kSpectrumChannels || !out) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!published_) {
+        return 0;
+    }
+    const std::size_t count = std::min(max, bins_);
+    std::memcpy(out, published_amplitude_.data() + channel * bins_, count * sizeof(float));
+    return count;
+}
+
+} // namespace wt9011
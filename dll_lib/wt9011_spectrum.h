@@ -0,0 +1,90 @@
+#ifndef WT9011_SPECTRUM_H
+#define WT9011_SPECTRUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "wt9011_api.h"
+#include "wt9011_types.h"
+
+namespace wt9011 {
+
+constexpr unsigned kMinFftSize = 16;
+constexpr unsigned kMaxFftSize = 65536;
+constexpr std::size_t kSpectrumChannels = 9;
+
+// Radix-2 FFT of real input of length n, computed as a complex FFT of n / 2
+// points. Tables are built once; transforms never allocate.
+class FftPlan {
+public:
+    explicit FftPlan(std::size_t n);
+
+    std::size_t size() const { return n_; }
+    // X[0 .. n / 2] of `in` (n values) into re/im; work_re/work_im hold n / 2
+    void forward(const float* in, float* re, float* im, float* work_re, float* work_im) const;
+
+private:
+    std::size_t n_;
+    std::size_t half_;
+    std::vector<std::uint32_t> bitrev_;
+    std::vector<float> twiddle_re_, twiddle_im_; // exp(-2 pi i j / half), j < half / 2
+    std::vector<float> split_re_, split_im_;     // exp(-2 pi i k / n), k <= half
+};
+
+// Windowed FFTs of the selected channels every `hop` samples, reduced to band
+// energies and the strongest peaks. The window mean is removed first so
+// gravity does not leak into the low bins. Buffers are sized by the config.
+class SpectrumAnalyzer {
+public:
+    // Null on an invalid config
+    static std::unique_ptr<SpectrumAnalyzer> create(const SpectrumConfig& config);
+
+    // Delivering thread; true when this sample completed an analysis
+    bool add(const SensorSample& sample);
+    // Any thread; false before the first analysis
+    bool latest(SpectrumReport& out) const;
+    // Amplitude spectrum of `channel` from the latest analysis, bin k at
+    // k * sample_rate / fft_size; returns the number of bins copied
+    std::size_t latest_bins(std::size_t channel, float* out, std::size_t max) const;
+
+    // The report add() just produced; delivering thread only
+    const SpectrumReport& report() const { return report_; }
+
+private:
+    explicit SpectrumAnalyzer(const SpectrumConfig& config);
+    void analyse(std::uint64_t timestamp_ns);
+
+    const SpectrumConfig config_;
+    const std::size_t n_;
+    const std::size_t bins_;
+    FftPlan plan_;
+    std::vector<float> window_;
+    float coherent_gain_ = 0.0f; // Sum of the window
+    float power_scale_ = 0.0f;   // Turns |X|^2 into mean square
+    std::vector<float> history_; // kSpectrumChannels x n_, ring
+    std::size_t pos_ = 0;
+    std::size_t filled_ = 0;
+    std::size_t since_ = 0;
+    std::uint64_t analyses_ = 0;
+    std::vector<float> frame_, re_, im_, work_re_, work_im_;
+    std::vector<float> amplitude_; // kSpectrumChannels x bins_
+    SpectrumReport report_ = {};
+
+    mutable std::mutex mutex_;
+    bool published_ = false;
+    SpectrumReport published_report_ = {};
+    std::vector<float> published_amplitude_;
+};
+
+// Spectrum stage of one session
+struct SpectrumStage {
+    std::unique_ptr<SpectrumAnalyzer> analyzer;
+    SessionSpectrumCallback callback;
+    void* user;
+};
+
+} // namespace wt9011
+
+#endif // WT9011_SPECTRUM_H
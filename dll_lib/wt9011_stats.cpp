@@ -0,0 +1,82 @@
+#include "wt9011_stats.h"
+#include "wt9011_api.h"
+
+namespace wt9011 {
+
+void LatencyHistogram::snapshot(LatencyStats& out) const {
+    std::uint64_t counts[kBuckets];
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        counts[i] = counts_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    const std::uint64_t max = max_.load(std::memory_order_relaxed);
+    out.count = total;
+    out.mean_ns = total ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(total) : 0.0;
+    out.max_ns = max;
+
+    // Walk the buckets once, filling every percentile as its rank is reached
+    const double quantiles[] = { 0.50, 0.90, 0.99, 0.999 };
+    unsigned long long* targets[] = { &out.p50_ns, &out.p90_ns, &out.p99_ns, &out.p999_ns };
+    std::size_t next = 0;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets && next < 4; ++i) {
+        seen += counts[i];
+        while (next < 4 && total > 0 && static_cast<double>(seen) >= quantiles[next] * static_cast<double>(total)) {
+            const std::uint64_t upper = bucket_upper(i);
+            *targets[next++] = upper < max ? upper : max;
+        }
+    }
+    for (; next < 4; ++next) {
+        *targets[next] = 0;
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+PipelineCounters& counters() {
+    static PipelineCounters instance;
+    return instance;
+}
+
+} // namespace wt9011
+
+WT9011_API PipelineStats wt9011_get_stats() {
+    const wt9011::PipelineCounters& c = wt9011::counters();
+    PipelineStats stats = {};
+    stats.packets_received = c.packets.load(std::memory_order_relaxed);
+    stats.bytes_received = c.bytes.load(std::memory_order_relaxed);
+    stats.frames_decoded = c.frames.load(std::memory_order_relaxed);
+    stats.rejected_frames = c.rejected_frames.load(std::memory_order_relaxed);
+    stats.discarded_bytes = c.discarded_bytes.load(std::memory_order_relaxed);
+    stats.callbacks = c.callbacks.load(std::memory_order_relaxed);
+    stats.queue_drops = c.queue_drops.load(std::memory_order_relaxed);
+    stats.dispatch_drops = c.dispatch_drops.load(std::memory_order_relaxed);
+    c.dispatch_wait.snapshot(stats.dispatch_wait);
+    c.notify_to_decode.snapshot(stats.notify_to_decode);
+    c.decode_to_callback.snapshot(stats.decode_to_callback);
+    c.callback_duration.snapshot(stats.callback_duration);
+    return stats;
+}
+
+WT9011_API void wt9011_reset_stats() {
+    wt9011::PipelineCounters& c = wt9011::counters();
+    c.packets.store(0, std::memory_order_relaxed);
+    c.bytes.store(0, std::memory_order_relaxed);
+    c.frames.store(0, std::memory_order_relaxed);
+    c.rejected_frames.store(0, std::memory_order_relaxed);
+    c.discarded_bytes.store(0, std::memory_order_relaxed);
+    c.callbacks.store(0, std::memory_order_relaxed);
+    c.queue_drops.store(0, std::memory_order_relaxed);
+    c.dispatch_drops.store(0, std::memory_order_relaxed);
+    c.dispatch_wait.reset();
+    c.notify_to_decode.reset();
+    c.decode_to_callback.reset();
+    c.callback_duration.reset();
+}
@@ -0,0 +1,92 @@
+#ifndef WT9011_STATS_H
+#define WT9011_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "wt9011_types.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace wt9011 {
+
+inline unsigned highest_bit(std::uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+
+// Log-linear (HDR-style) histogram of nanosecond latencies. Values below 16
+// are exact; above that every power of two is split into 16 buckets, so any
+// reported value is within 6.25% of the recorded one. Recording is wait-free.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBits = 4;
+    static constexpr unsigned kSubBuckets = 1u << kSubBits;
+    static constexpr std::size_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    static std::size_t bucket_of(std::uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned exponent = highest_bit(value);
+        const std::uint64_t sub = (value >> (exponent - kSubBits)) - kSubBuckets;
+        return (exponent - kSubBits + 1) * kSubBuckets + static_cast<std::size_t>(sub);
+    }
+
+    // Largest value that falls into `bucket`
+    static std::uint64_t bucket_upper(std::size_t bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        const unsigned exponent = static_cast<unsigned>(bucket / kSubBuckets) + kSubBits - 1;
+        const std::uint64_t sub = bucket % kSubBuckets;
+        const unsigned shift = exponent - kSubBits;
+        return ((kSubBuckets + sub) << shift) + ((std::uint64_t(1) << shift) - 1);
+    }
+
+    void record(std::uint64_t value) {
+        counts_[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        std::uint64_t max = max_.load(std::memory_order_relaxed);
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void snapshot(LatencyStats& out) const;
+    void reset();
+
+private:
+    std::atomic<std::uint64_t> counts_[kBuckets] = {};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+// Process-wide pipeline counters, updated on the receive path
+struct PipelineCounters {
+    std::atomic<std::uint64_t> packets{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> frames{0};
+    std::atomic<std::uint64_t> rejected_frames{0};
+    std::atomic<std::uint64_t> discarded_bytes{0};
+    std::atomic<std::uint64_t> callbacks{0};
+    std::atomic<std::uint64_t> queue_drops{0};
+    std::atomic<std::uint64_t> dispatch_drops{0};
+
+    LatencyHistogram dispatch_wait;
+    LatencyHistogram notify_to_decode;
+    LatencyHistogram decode_to_callback;
+    LatencyHistogram callback_duration;
+};
+
+PipelineCounters& counters();
+
+} // namespace wt9011
+
+#endif // WT9011_STATS_H
@@ -0,0 +1,191 @@
+#ifndef WT9011_TYPES_H
+#define WT9011_TYPES_H
+
+#include <cstddef>
+#include <string>
+
+// Structure to hold device information
+struct DeviceInfo {
+    std::string name;
+    std::string address;
+};
+
+// Structure to hold sensor data
+struct SensorData {
+    struct Accel { float x, y, z; };
+    struct Gyro { float x, y, z; };
+    struct Angle { float roll, pitch, yaw; };
+    Accel accel;
+    Gyro gyro;
+    Angle angle;
+};
+
+// Sensor data with receive metadata, stamped when the notification arrives
+struct SensorSample {
+    SensorData data;
+    unsigned long long timestamp_ns; // Monotonic receive time, see wt9011_monotonic_ns
+    unsigned long long sequence;     // Per-session sample counter starting at 0
+};
+
+// Orientation filter of the fusion stage (see wt9011_fusion.h)
+enum FusionAlgorithm {
+    WT9011_FUSION_MADGWICK = 0,
+    WT9011_FUSION_MAHONY = 1
+};
+
+struct FusionConfig {
+    int algorithm;        // FusionAlgorithm
+    float gain;           // Madgwick beta or Mahony Kp; <= 0 picks the default
+    float integral_gain;  // Mahony Ki (gyro bias correction); ignored by Madgwick
+    float sample_rate_hz; // Fixed step if > 0, otherwise steps follow the sample timestamps
+};
+
+// Sample with the orientation the fusion stage estimated from accel and gyro
+struct FusedSample {
+    SensorSample sample;
+    float quaternion[4];   // w, x, y, z; rotates sensor-frame vectors into the earth frame (z up)
+    float linear_accel[3]; // accel with gravity removed, sensor frame, same units as accel
+};
+
+// Stage of a session's filter chain (see wt9011_filters.h)
+enum FilterType {
+    WT9011_FILTER_LOWPASS = 0,        // Biquad (RBJ cookbook) at cutoff_hz with quality q
+    WT9011_FILTER_HIGHPASS = 1,
+    WT9011_FILTER_BANDPASS = 2,       // cutoff_hz is the center frequency
+    WT9011_FILTER_NOTCH = 3,
+    WT9011_FILTER_MOVING_AVERAGE = 4, // Mean of the last `length` samples
+    WT9011_FILTER_MEDIAN = 5,         // Median of the last `length` samples
+    WT9011_FILTER_DECIMATE = 6        // Pass every `length`-th sample
+};
+
+// Channel bits of FilterStageConfig::channels, in SensorData order
+enum {
+    WT9011_CHANNEL_ACCEL = 0x007,
+    WT9011_CHANNEL_GYRO = 0x038,
+    WT9011_CHANNEL_ANGLE = 0x1C0,
+    WT9011_CHANNEL_ALL = 0x1FF
+};
+
+struct FilterStageConfig {
+    int type;          // FilterType
+    float cutoff_hz;   // Biquads only
+    float q;           // Biquads only; <= 0 picks 0.7071 (Butterworth)
+    unsigned length;   // Window of the moving average and median, decimation factor
+    unsigned channels; // WT9011_CHANNEL_* bits the stage filters; 0 means all
+};
+
+// Structure-of-arrays output for batch decoding; every array must hold `count` floats
+struct SensorDataSoA {
+    float* ax;
+    float* ay;
+    float* az;
+    float* gx;
+    float* gy;
+    float* gz;
+    float* roll;
+    float* pitch;
+    float* yaw;
+};
+
+// Latency distribution of one pipeline stage, in nanoseconds
+struct LatencyStats {
+    unsigned long long count;
+    double mean_ns;
+    unsigned long long p50_ns;
+    unsigned long long p90_ns;
+    unsigned long long p99_ns;
+    unsigned long long p999_ns;
+    unsigned long long max_ns;
+};
+
+// Counters of the receive pipeline since start (or wt9011_reset_stats)
+struct PipelineStats {
+    unsigned long long packets_received;  // BLE notifications
+    unsigned long long bytes_received;
+    unsigned long long frames_decoded;
+    unsigned long long rejected_frames;   // Resyncs on a bad header, unmatched register replies, decode failures
+    unsigned long long discarded_bytes;   // Skipped while resynchronizing on headers
+    unsigned long long callbacks;
+    unsigned long long queue_drops;       // Samples lost to a full poll queue
+    unsigned long long dispatch_drops;    // Notifications lost while the dispatch workers fell behind
+    LatencyStats dispatch_wait;           // BLE notification arrival -> picked up by a dispatch worker
+    LatencyStats notify_to_decode;        // Delivery of the notification -> frame decoded
+    LatencyStats decode_to_callback;      // Frame decoded -> callback invoked
+    LatencyStats callback_duration;       // Time spent inside the callback
+};
+
+// One channel over a sliding window
+struct ChannelWindowStats {
+    double mean;
+    double variance; // Population variance
+    double rms;
+    double min;
+    double max;
+};
+
+// All nine channels over a sliding window ending at the newest sample
+// (wt9011_session_window_stats)
+struct WindowStats {
+    unsigned long long count; // Samples in the window
+    unsigned long long first_timestamp_ns;
+    unsigned long long last_timestamp_ns;
+    ChannelWindowStats channels[9]; // ax ay az gx gy gz roll pitch yaw
+};
+
+// Live spectral analysis of a session (see wt9011_spectrum.h)
+enum SpectrumWindow {
+    WT9011_WINDOW_HANN = 0,
+    WT9011_WINDOW_BLACKMAN = 1
+};
+
+enum {
+    WT9011_SPECTRUM_MAX_BANDS = 8,
+    WT9011_SPECTRUM_PEAKS = 3
+};
+
+struct SpectrumConfig {
+    unsigned fft_size;    // Power of two, 16 .. 65536
+    unsigned hop;         // Samples between analyses, 1 .. fft_size; 0 = fft_size / 2 (50% overlap)
+    int window;           // SpectrumWindow
+    unsigned channels;    // WT9011_CHANNEL_* bits to analyse; 0 means all
+    float sample_rate_hz;
+    unsigned band_count;  // Up to WT9011_SPECTRUM_MAX_BANDS
+    float band_edges_hz[WT9011_SPECTRUM_MAX_BANDS + 1]; // Band i spans edges[i] .. edges[i + 1]
+};
+
+struct SpectrumPeak {
+    float frequency_hz;
+    float amplitude; // Of a sine at that frequency, in channel units
+};
+
+struct ChannelSpectrum {
+    float band_energy[WT9011_SPECTRUM_MAX_BANDS]; // Mean square of the signal within each band
+    SpectrumPeak peaks[WT9011_SPECTRUM_PEAKS];   // Strongest first; zero when there are fewer
+};
+
+struct SpectrumReport {
+    unsigned long long timestamp_ns; // Newest sample of the analysed window
+    unsigned long long index;        // Analyses since the spectrum stage was set
+    unsigned channels;               // WT9011_CHANNEL_* bits that were analysed
+    ChannelSpectrum channel[9];      // ax ay az gx gy gz roll pitch yaw
+};
+
+// One chunk of a recording, pointing straight into the mapped file;
+// every column holds `count` values
+struct RecordingChunk {
+    size_t count;
+    const unsigned long long* timestamp_ns;
+    const unsigned long long* sequence;
+    const unsigned int* sensor_id;
+    const float* ax;
+    const float* ay;
+    const float* az;
+    const float* gx;
+    const float* gy;
+    const float* gz;
+    const float* roll;
+    const float* pitch;
+    const float* yaw;
+};
+
+#endif // WT9011_TYPES_H
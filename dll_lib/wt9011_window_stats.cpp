@@ -0,0 +1,151 @@
+#include "wt9011_window_stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace wt9011 {
+
+namespace {
+
+float channel(const SensorData& data, std::size_t c) {
+    switch (c) {
+    case 0: return data.accel.x;
+    case 1: return data.accel.y;
+    case 2: return data.accel.z;
+    case 3: return data.gyro.x;
+    case 4: return data.gyro.y;
+    case 5: return data.gyro.z;
+    case 6: return data.angle.roll;
+    case 7: return data.angle.pitch;
+    default: return data.angle.yaw;
+    }
+}
+
+std::size_t round_up_pow2(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+} // namespace
+
+SlidingWindow::SlidingWindow(std::uint64_t window_ns, std::size_t capacity)
+    : window_ns_(window_ns), capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1), timestamps_(capacity_),
+      values_(capacity_ * kWindowChannels), min_slots_(capacity_ * kWindowChannels),
+      max_slots_(capacity_ * kWindowChannels) {}
+
+template <typename Keep>
+void SlidingWindow::push_locked(Deque& deque, std::uint64_t* slots, std::uint64_t seq, std::size_t channel,
+                                Keep keep) {
+    const float x = value(seq, channel);
+    while (deque.size > 0 && !keep(value(slots[(deque.head + deque.size - 1) & mask_], channel), x)) {
+        --deque.size;
+    }
+    slots[(deque.head + deque.size) & mask_] = seq;
+    ++deque.size;
+}
+
+void SlidingWindow::pop_front_locked(Deque& deque, const std::uint64_t* slots, std::uint64_t seq) {
+    if (deque.size > 0 && slots[deque.head] == seq) {
+        deque.head = (deque.head + 1) & mask_;
+        --deque.size;
+    }
+}
+
+void SlidingWindow::add(const SensorSample& sample) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::uint64_t now = sample.timestamp_ns;
+    while (next_ > first_ && timestamps_[first_ & mask_] + window_ns_ <= now) {
+        remove_oldest_locked();
+    }
+    if (next_ - first_ == capacity_) {
+        remove_oldest_locked();
+    }
+    const std::uint64_t seq = next_++;
+    const std::size_t slot = seq & mask_;
+    timestamps_[slot] = now;
+    const double n = static_cast<double>(next_ - first_);
+    for (std::size_t c = 0; c < kWindowChannels; ++c) {
+        const float x = channel(sample.data, c);
+        values_[slot * kWindowChannels + c] = x;
+        const double d = x - mean_[c];
+        mean_[c] += d / n;
+        m2_[c] += d * (x - mean_[c]);
+        push_locked(min_[c], min_slots_.data() + c * capacity_, seq, c, [](float back, float v) { return back < v; });
+        push_locked(max_[c], max_slots_.data() + c * capacity_, seq, c, [](float back, float v) { return back > v; });
+    }
+}
+
+void SlidingWindow::remove_oldest_locked() {
+    const std::uint64_t seq = first_;
+    const double remaining = static_cast<double>(next_ - first_ - 1);
+    for (std::size_t c = 0; c < kWindowChannels; ++c) {
+        const double y = value(seq, c);
+        if (remaining == 0.0) {
+            mean_[c] = 0.0;
+            m2_[c] = 0.0;
+        } else {
+            const double d = y - mean_[c];
+            mean_[c] -= d / remaining;
+            m2_[c] -= d * (y - mean_[c]);
+        }
+        pop_front_locked(min_[c], min_slots_.data() + c * capacity_, seq);
+        pop_front_locked(max_[c], max_slots_.data() + c * capacity_, seq);
+    }
+    ++first_;
+    if ((first_ & mask_) == 0) {
+        resum_locked();
+    }
+}
+
+// Recompute the moments from the stored samples once per `capacity_`
+// removals, so the downdates cannot drift; O(1) amortized
+void SlidingWindow::resum_locked() {
+    const std::uint64_t count = next_ - first_;
+    for (std::size_t c = 0; c < kWindowChannels; ++c) {
+        double mean = 0.0;
+        for (std::uint64_t seq = first_; seq < next_; ++seq) {
+            mean += value(seq, c);
+        }
+        mean = count ? mean / static_cast<double>(count) : 0.0;
+        double m2 = 0.0;
+        for (std::uint64_t seq = first_; seq < next_; ++seq) {
+            const double d = value(seq, c) - mean;
+            m2 += d * d;
+        }
+        mean_[c] = mean;
+        m2_[c] = m2;
+    }
+}
+
+void SlidingWindow::query(WindowStats& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out = WindowStats{};
+    const std::uint64_t count = next_ - first_;
+    out.count = count;
+    if (count == 0) {
+        return;
+    }
+    out.first_timestamp_ns = timestamps_[first_ & mask_];
+    out.last_timestamp_ns = timestamps_[(next_ - 1) & mask_];
+    for (std::size_t c = 0; c < kWindowChannels; ++c) {
+        ChannelWindowStats& s = out.channels[c];
+        s.mean = mean_[c];
+        s.variance = std::max(m2_[c] / static_cast<double>(count), 0.0);
+        s.rms = std::sqrt(s.variance + s.mean * s.mean);
+        s.min = value(min_slots_[c * capacity_ + min_[c].head], c);
+        s.max = value(max_slots_[c * capacity_ + max_[c].head], c);
+    }
+}
+
+void SlidingWindow::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    first_ = next_ = 0;
+    std::fill(std::begin(mean_), std::end(mean_), 0.0);
+    std::fill(std::begin(m2_), std::end(m2_), 0.0);
+    std::fill(std::begin(min_), std::end(min_), Deque{});
+    std::fill(std::begin(max_), std::end(max_), Deque{});
+}
+
+} // namespace wt9011
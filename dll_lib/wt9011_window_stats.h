@@ -0,0 +1,71 @@
+#ifndef WT9011_WINDOW_STATS_H
+#define WT9011_WINDOW_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "wt9011_types.h"
+
+namespace wt9011 {
+
+constexpr std::size_t kWindowChannels = 9;
+// Sample rate the window capacity is sized for when none is given
+constexpr double kDefaultWindowRateHz = 200.0;
+
+// Mean, variance, RMS, min and max of every channel over the samples of the
+// last `window_ns`, each updated in O(1) amortized per sample: sliding
+// Welford sums for the moments, monotonic deques for the extremes. Storage
+// is fixed at construction, `capacity` rounded up to a power of two; once
+// that many samples are in the window the oldest leaves early. add() runs on
+// the delivering thread, query() on any.
+class SlidingWindow {
+public:
+    SlidingWindow(std::uint64_t window_ns, std::size_t capacity);
+
+    void add(const SensorSample& sample);
+    void query(WindowStats& out) const;
+    void clear();
+
+private:
+    // Sequence numbers of window samples whose values are monotonic from
+    // front to back, in a ring of capacity_ entries
+    struct Deque {
+        std::size_t head = 0;
+        std::size_t size = 0;
+    };
+
+    float value(std::uint64_t seq, std::size_t channel) const {
+        return values_[(seq & mask_) * kWindowChannels + channel];
+    }
+    void remove_oldest_locked();
+    void resum_locked();
+    template <typename Keep>
+    void push_locked(Deque& deque, std::uint64_t* slots, std::uint64_t seq, std::size_t channel, Keep keep);
+    void pop_front_locked(Deque& deque, const std::uint64_t* slots, std::uint64_t seq);
+
+    const std::uint64_t window_ns_;
+    const std::size_t capacity_; // Power of two
+    const std::size_t mask_;
+    mutable std::mutex mutex_;
+    std::vector<std::uint64_t> timestamps_;
+    std::vector<float> values_; // capacity_ x kWindowChannels
+    std::uint64_t first_ = 0;   // Sequence number of the oldest sample in the window
+    std::uint64_t next_ = 0;    // Sequence number of the next sample
+    double mean_[kWindowChannels] = {};
+    double m2_[kWindowChannels] = {};
+    Deque min_[kWindowChannels];
+    Deque max_[kWindowChannels];
+    std::vector<std::uint64_t> min_slots_; // kWindowChannels x capacity_
+    std::vector<std::uint64_t> max_slots_;
+};
+
+// The windows a session keeps (wt9011_session_set_windows)
+struct WindowSet {
+    std::vector<std::unique_ptr<SlidingWindow>> windows;
+};
+
+} // namespace wt9011
+
+#endif // WT9011_WINDOW_STATS_H
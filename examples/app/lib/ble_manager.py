@@ -6,10 +6,37 @@ from typing import Callable, Optional, List, Dict
 from bleak import BleakClient, BleakScanner, BleakError
 import logging
 
-# Настройка логирования для отладки
-logging.basicConfig(level=logging.DEBUG)
+# DEBUG включается явно; сырые пакеты пишет трассировка wt9011_log_trace_packets
+logging.basicConfig(level=logging.INFO)
 logger = logging.getLogger(__name__)
 
+# Регистры команд-действий: их нельзя объединять, и объединение настроек не
+# переносит команду через них (обнуление, калибровка, сохранение, сброс,
+# сон/пробуждение, чтение регистра, разблокировка)
+_BARRIER_REGISTERS = {0x00, 0x01, 0x03, 0x06, 0x27, 0x52, 0x69}
+
+
+def _coalesce_key(command: bytes) -> Optional[int]:
+    """Регистр команды записи FF AA reg ..., если её можно заменить более новой"""
+    if len(command) >= 4 and command[0] == 0xFF and command[1] == 0xAA:
+        register = command[2]
+        if register not in _BARRIER_REGISTERS:
+            return register
+    return None
+
+
+def _is_writable(char) -> bool:
+    return "write" in char.properties or "write-without-response" in char.properties
+
+
+class _PendingCommand:
+    __slots__ = ("key", "command", "waiters")
+
+    def __init__(self, key: Optional[int], command: bytes, waiter: asyncio.Future):
+        self.key = key
+        self.command = command
+        self.waiters = [waiter]
+
 
 class BLEManager:
     """
@@ -20,6 +47,12 @@ class BLEManager:
         self.client: Optional[BleakClient] = None
         self.notify_char_uuid: Optional[str] = None
         self.write_char_uuid: Optional[str] = None
+        # Характеристика записи определяется один раз при подключении
+        self._write_char = None
+        self._write_response = True
+        # Очередь команд: пишет одна задача, повторные настройки объединяются
+        self._commands: List[_PendingCommand] = []
+        self._writer: Optional[asyncio.Task] = None
         self.loop = None
         logger.info("BLEManager initialized")
 
@@ -108,18 +141,38 @@ class BLEManager:
                 raise RuntimeError("No services found on the device")
             logger.info(f"Found {len(services.services)} services")
 
-            # Iterate through services to find notify and write characteristics
+            self._write_char = None
+            self._write_response = True
+
+            # Iterate through services to find notify and write characteristics.
+            # Commands go to the first writable characteristic of the notify
+            # characteristic's service, falling back to the first writable one
+            # anywhere; write-without-response is used if that one allows it
+            notify_service = None
+            first_writable = None
             for service in services:
-                logger.debug(f"Service: {service.uuid}")
+                logger.debug("Service: %s", service.uuid)
                 for char in service.characteristics:
-                    logger.debug(f"  Characteristic: {char.uuid}, Properties: {char.properties}")
+                    logger.debug("  Characteristic: %s, Properties: %s", char.uuid, char.properties)
                     if "notify" in char.properties and not self.notify_char_uuid:
                         self.notify_char_uuid = char.uuid
+                        notify_service = service
                         logger.info(f"Found notify characteristic: {char.uuid}")
-                    if (
-                            "write" in char.properties or "write-without-response" in char.properties) and not self.write_char_uuid:
-                        self.write_char_uuid = char.uuid
-                        logger.info(f"Found write characteristic: {char.uuid}")
+                    if first_writable is None and _is_writable(char):
+                        first_writable = char
+
+            if notify_service is not None:
+                self._write_char = next((char for char in notify_service.characteristics if _is_writable(char)),
+                                        None)
+            if self._write_char is None:
+                self._write_char = first_writable
+            if self._write_char:
+                self._write_response = "write-without-response" not in self._write_char.properties
+                self.write_char_uuid = self._write_char.uuid
+
+            if self._write_char:
+                logger.info(f"Found write characteristic: {self.write_char_uuid}"
+                            f" ({'with' if self._write_response else 'without'} response)")
 
             if not self.notify_char_uuid:
                 logger.error("No notify characteristic found")
@@ -142,14 +195,10 @@ class BLEManager:
             raise RuntimeError("No notify characteristic found")
 
         def notification_handler(sender, data: bytearray):
-            logger.debug(f"Raw data received (len={len(data)}): {data.hex()}")
             try:
-                # Проверяем минимальную длину и заголовок пакета
-                if len(data) >= 2 and data[0] == 0x55:
-                    logger.debug(f"Valid packet header found: 0x{data[0]:02X} 0x{data[1]:02X}")
-                    on_data(data)
-                else:
-                    logger.warning(f"Invalid packet: {data.hex()}")
+                # Пакеты передаются целиком: кадр может быть разбит на несколько
+                # уведомлений, сборка и синхронизация по 0x55 выполняются в C++
+                on_data(data)
             except Exception as e:
                 logger.error(f"Error in notification handler: {str(e)}")
 
@@ -162,22 +211,66 @@ class BLEManager:
 
     async def send(self, command: bytes) -> None:
         """
-        Отправляет команду на устройство.
+        Ставит команду в очередь устройства и ждёт, пока она будет записана.
+
+        Команды пишутся по порядку одной задачей, без ответа, если характеристика
+        это позволяет. Настройка регистра, ещё ожидающая в очереди, заменяется
+        новой (например, повторный set_return_rate); оба вызова завершаются после
+        записи нового значения.
         """
         if not self.client or not self.client.is_connected:
             logger.error("No connection established")
             raise RuntimeError("No connection established")
 
-        if not self.write_char_uuid:
+        if not self._write_char:
             logger.error("No write characteristic found")
             raise RuntimeError("No write characteristic found")
 
-        try:
-            await self.client.write_gatt_char(self.write_char_uuid, command)
-            logger.info(f"Sent command: {command.hex()}")
-        except Exception as e:
-            logger.error(f"Failed to send command: {str(e)}")
-            raise
+        command = bytes(command)
+        loop = asyncio.get_running_loop()
+        waiter = loop.create_future()
+        key = _coalesce_key(command)
+        pending = None
+        if key is not None:
+            # Только среди команд после последнего действия
+            for queued in reversed(self._commands):
+                if queued.key is None:
+                    break
+                if queued.key == key:
+                    pending = queued
+                    break
+        if pending:
+            pending.command = command
+            pending.waiters.append(waiter)
+        else:
+            self._commands.append(_PendingCommand(key, command, waiter))
+
+        if not self._writer or self._writer.done():
+            self._writer = loop.create_task(self._write_commands())
+        await waiter
+
+    async def _write_commands(self) -> None:
+        while self._commands:
+            pending = self._commands.pop(0)
+            try:
+                await self.client.write_gatt_char(self._write_char, pending.command,
+                                                  response=self._write_response)
+                logger.debug("Sent command: %s", pending.command.hex())
+                for waiter in pending.waiters:
+                    if not waiter.done():
+                        waiter.set_result(None)
+            except Exception as e:
+                logger.error(f"Failed to send command: {str(e)}")
+                for waiter in pending.waiters:
+                    if not waiter.done():
+                        waiter.set_exception(e)
+
+    def _fail_pending_commands(self) -> None:
+        commands, self._commands = self._commands, []
+        for pending in commands:
+            for waiter in pending.waiters:
+                if not waiter.done():
+                    waiter.set_exception(RuntimeError("Disconnected"))
 
     async def disconnect(self) -> None:
         """
@@ -191,9 +284,12 @@ class BLEManager:
                 logger.error(f"Disconnect failed: {str(e)}")
                 raise
 
+        self._fail_pending_commands()
         self.client = None
         self.notify_char_uuid = None
         self.write_char_uuid = None
+        self._write_char = None
+        self._write_response = True
 
 
 # Глобальный экземпляр для использования в C++
@@ -8,7 +8,10 @@ class WT9011Parser:
     @staticmethod
     def parse(data: bytearray) -> Optional[Dict[str, Dict[str, float]]]:
         try:
-            logger.debug(f"Raw data (len={len(data)}): {data.hex()}")
+            # f-строки вычислялись бы для каждого пакета даже при выключенном DEBUG
+            debug = logger.isEnabledFor(logging.DEBUG)
+            if debug:
+                logger.debug("Raw data (len=%d): %s", len(data), data.hex())
 
             # Минимальная длина пакета - 20 байт (без checksum)
             if len(data) < 20:
@@ -48,7 +51,8 @@ class WT9011Parser:
                     "yaw": (yaw / 32768 * 180) - 360 if yaw / 32768 * 180 > 180 else yaw / 32768 * 180
                 }
             }
-            logger.debug(f"Parsed data: {result}")
+            if debug:
+                logger.debug("Parsed data: %s", result)
             return result
 
         except Exception as e:
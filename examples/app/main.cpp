@@ -25,10 +25,12 @@
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QFile>
+#include <cmath>
 #include <vector>
 #include <memory>
 #include "qcustomplot.h"
 #include "wt9011_interface.h"
+#include "wt9011_log.h"
 
 struct DataPoint {
     QDateTime timestamp;
@@ -38,95 +40,88 @@ struct DataPoint {
 class SensorDataWidget : public QWidget {
     Q_OBJECT
 public:
+    // Отрезок времени на графике; по нему же библиотека считает статистику
+    // для автомасштабирования (wt9011_set_windows)
+    static constexpr double kPlotWindowSeconds = 60.0;
+    // Точек в кольцевом буфере каждой кривой: окно целиком при частоте до ~500 Гц
+    static constexpr int kPlotCapacity = 32768;
+    // Период кадра: раз в кадр забираем накопленные образцы и перерисовываем график
+    static constexpr int kFrameIntervalMs = 16;
+    static constexpr size_t kPollBatch = 256;
+    static constexpr double kYAxisStep = 0.5;
+
     SensorDataWidget(QWidget* parent = nullptr) : QWidget(parent) {
         setupUi();
         dataHistory.reserve(1000);
 
-        // Инициализация графиков
-        accelXCurve = graphWidget->addGraph();
-        accelYCurve = graphWidget->addGraph();
-        accelZCurve = graphWidget->addGraph();
-
-        accelXCurve->setPen(QPen(Qt::red));
-        accelYCurve->setPen(QPen(Qt::green));
-        accelZCurve->setPen(QPen(Qt::blue));
-
-        accelXCurve->setName("Accel X");
-        accelYCurve->setName("Accel Y");
-        accelZCurve->setName("Accel Z");
-
-        graphWidget->xAxis->setLabel("Время (с)");
-        graphWidget->yAxis->setLabel("Значение");
-        graphWidget->legend->setVisible(true);
-        graphWidget->yAxis->setRange(-2, 2);
+        // Кривые созданы в setupUi(); график рисует прямо из их колец
+        for (QCPGraph* curve : {accelXCurve, accelYCurve, accelZCurve}) {
+            curve->data()->setCapacity(kPlotCapacity);
+        }
 
-        updateTimer = new QTimer(this);
-        connect(updateTimer, &QTimer::timeout, this, [this]() {
-            if (!timeData.isEmpty()) {
-                graphWidget->replot();
-            }
-        });
-        updateTimer->start(100);
+        // Образцы копятся в очереди библиотеки (wt9011_receive_samples(nullptr)),
+        // GUI забирает их пачкой раз в кадр (startUpdates): одна перерисовка на кадр
+        // при любой частоте датчика, и ничего не теряется, если окно не в фокусе
+        samples.resize(kPollBatch);
+        frameTimer = new QTimer(this);
+        frameTimer->setTimerType(Qt::PreciseTimer);
+        connect(frameTimer, &QTimer::timeout, this, &SensorDataWidget::drainSamples);
 
-        startTime = QDateTime::currentDateTime().toMSecsSinceEpoch() / 1000.0;
+        startTime = wt9011_monotonic_ns() / 1e9;
     }
 
-    void updateData(const SensorData* data) {
-    if (!data) return;  // Проверка на нулевой указатель
-
-    double time = QDateTime::currentDateTime().toMSecsSinceEpoch() / 1000.0 - startTime;
+    void drainSamples() {
+        bool added = false;
+        size_t count;
+        while ((count = wt9011_poll_samples(samples.data(), samples.size())) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                // В сборках без WT9011_LOG_LEVEL=0 строка удаляется препроцессором
+                WT9011_LOG_TRACE("Sample %llu: accel=(%f, %f, %f)", samples[i].sequence, samples[i].data.accel.x,
+                                 samples[i].data.accel.y, samples[i].data.accel.z);
+                addSample(samples[i]);
+            }
+            added = true;
+        }
+        if (!added) {
+            return;
+        }
 
-    // Всегда добавляем новые точки
-    timeData.append(time);
-    accelXData.append(data->accel.x);
-    accelYData.append(data->accel.y);
-    accelZData.append(data->accel.z);
+        // Ось X: всегда отрезок kPlotWindowSeconds до последнего образца. Ширина
+        // постоянна, поэтому график только сдвигает уже нарисованное и дорисовывает
+        // новые точки (QCustomPlot перерисовывает всё лишь при смене масштаба)
+        const QCPDataRing* points = accelXCurve->data();
+        const double time = points->key(points->size() - 1);
+        graphWidget->xAxis->setRange(time - kPlotWindowSeconds, time);
+
+        // Автомасштабирование по оси Y: минимум и максимум акселерометра за окно
+        // графика из скользящей статистики библиотеки, без повторного прохода по данным.
+        // Границы округляются до kYAxisStep, чтобы масштаб менялся редко
+        WindowStats stats;
+        if (wt9011_window_stats(0, &stats) && stats.count > 0) {
+            double minY = qMin(qMin(stats.channels[0].min, stats.channels[1].min), stats.channels[2].min);
+            double maxY = qMax(qMax(stats.channels[0].max, stats.channels[1].max), stats.channels[2].max);
+            double padding = 0.5;
+            graphWidget->yAxis->setRange(std::floor((minY - padding) / kYAxisStep) * kYAxisStep,
+                                         std::ceil((maxY + padding) / kYAxisStep) * kYAxisStep);
+        }
 
-    // Ограничиваем размер буфера данных
-    if (timeData.size() > 100) {
-        timeData.removeFirst();
-        accelXData.removeFirst();
-        accelYData.removeFirst();
-        accelZData.removeFirst();
+        graphWidget->replot();
     }
 
-    // Обновляем графики
-    accelXCurve->setData(timeData, accelXData);
-    accelYCurve->setData(timeData, accelYData);
-    accelZCurve->setData(timeData, accelZData);
-
-    // Автомасштабирование по оси X
-    if (timeData.size() == 1) {
-        double time = timeData.first();
-        graphWidget->xAxis->setRange(time - 0.1, time + 0.1);
-    } else {
-        graphWidget->xAxis->setRange(timeData.first(), timeData.last());
+    void startUpdates() {
+        frameTimer->start(kFrameIntervalMs);
     }
 
-    // Автомасштабирование по оси Y
-    double minY = qMin(qMin(accelXData.last(), accelYData.last()), accelZData.last());
-    double maxY = qMax(qMax(accelXData.last(), accelYData.last()), accelZData.last());
-    double padding = 0.5;
-    graphWidget->yAxis->setRange(minY - padding, maxY + padding);
-
-    graphWidget->replot();
-}
-
     void stopUpdates() {
-        updateTimer->stop();
+        frameTimer->stop();
     }
 
     void clearData() {
-        timeData.clear();
-        accelXData.clear();
-        accelYData.clear();
-        accelZData.clear();
+        accelXCurve->data()->clear();
+        accelYCurve->data()->clear();
+        accelZCurve->data()->clear();
 
-        accelXCurve->setData(timeData, accelXData);
-        accelYCurve->setData(timeData, accelYData);
-        accelZCurve->setData(timeData, accelZData);
-
-        graphWidget->xAxis->setRange(0, 10);
+        graphWidget->xAxis->setRange(0, kPlotWindowSeconds);
         graphWidget->yAxis->setRange(-2, 2);
 
         graphWidget->replot();
@@ -135,6 +130,20 @@ public:
     const QVector<DataPoint>& getDataHistory() const { return dataHistory; }
 
 private:
+    void addSample(const SensorSample& sample) {
+        // Время приёма пакета, а не момент отрисовки
+        const double time = sample.timestamp_ns / 1e9 - startTime;
+
+        // Новая точка в кольцо каждой кривой и отсечение отрезка kPlotWindowSeconds:
+        // O(1) на образец при любой длине окна, без копирования
+        const float values[] = {sample.data.accel.x, sample.data.accel.y, sample.data.accel.z};
+        QCPGraph* curves[] = {accelXCurve, accelYCurve, accelZCurve};
+        for (int i = 0; i < 3; ++i) {
+            curves[i]->addData(time, values[i]);
+            curves[i]->data()->removeBefore(time - kPlotWindowSeconds);
+        }
+    }
+
     void setupUi() {
         QVBoxLayout* layout = new QVBoxLayout(this);
 
@@ -199,7 +208,7 @@ private:
         graphWidget->yAxis->setRange(-2, 2);
         layout->addWidget(graphWidget);
 
-        startTime = QDateTime::currentDateTime().toMSecsSinceEpoch() / 1000.0;
+        startTime = wt9011_monotonic_ns() / 1e9;
     }
 
     QLabel* accelXLabel;
@@ -215,13 +224,10 @@ private:
     QCPGraph* accelXCurve;
     QCPGraph* accelYCurve;
     QCPGraph* accelZCurve;
-    QVector<double> timeData;
-    QVector<double> accelXData;
-    QVector<double> accelYData;
-    QVector<double> accelZData;
     QVector<DataPoint> dataHistory;
     double startTime;
-    QTimer* updateTimer;
+    std::vector<SensorSample> samples; // Пачка, забираемая из очереди за раз
+    QTimer* frameTimer;
 };
 class ControlPanel : public QWidget {
     Q_OBJECT
@@ -366,10 +372,12 @@ private slots:
                 disconnectBtn->setEnabled(true);
                 connectBtn->setText("Подключить");
                 addLog("Успешно подключено к устройству");
+                wt9011_set_windows(&SensorDataWidget::kPlotWindowSeconds, 1, 0.0);
 
-                if (wt9011_receive([](const SensorData* data) {
-                    QCoreApplication::postEvent(qApp->activeWindow(), new SensorDataEvent(*data));
-                })) {
+                // Без функции обратного вызова образцы идут в очередь, её раз в кадр
+                // разбирает SensorDataWidget::drainSamples
+                if (wt9011_receive_samples(nullptr)) {
+                    sensorDataWidget->startUpdates();
                     addLog("Начало приема данных");
                 } else {
                     handleError("Ошибка начала приема данных");
@@ -387,6 +395,9 @@ private slots:
 
         // Используем публичный метод для остановки таймера
         sensorDataWidget->stopUpdates();
+        if (isRecording) {
+            toggleRecording();
+        }
 
         if (wt9011_disconnect()) {
             isConnected = false;
@@ -413,6 +424,40 @@ private slots:
         }
     }
 
+    // Потоковая запись в файл библиотеки, память не растёт со временем записи
+    void toggleRecording() {
+        if (isRecording) {
+            if (wt9011_record_stop()) {
+                addLog("Запись остановлена");
+            } else {
+                handleError("Ошибка завершения записи");
+            }
+            isRecording = false;
+            recordBtn->setText("Начать запись");
+            return;
+        }
+        if (!isConnected) {
+            QMessageBox::warning(this, "Предупреждение", "Устройство не подключено");
+            return;
+        }
+
+        QString filename = QFileDialog::getSaveFileName(
+            this, "Записать данные",
+            QString("sensor_data_%1.wtr").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+            "WT9011 recordings (*.wtr)"
+        );
+        if (filename.isEmpty()) {
+            return;
+        }
+        if (wt9011_record_start(filename.toStdString().c_str())) {
+            isRecording = true;
+            recordBtn->setText("Остановить запись");
+            addLog(QString("Запись в %1").arg(filename));
+        } else {
+            handleError("Ошибка начала записи");
+        }
+    }
+
     void saveJson() {
         const auto& history = sensorDataWidget->getDataHistory();
         if (history.isEmpty()) {
@@ -540,8 +585,11 @@ private:
         QPushButton* saveCsvBtn = new QPushButton("Сохранить CSV");
         connect(saveJsonBtn, &QPushButton::clicked, this, &MainWindow::saveJson);
         connect(saveCsvBtn, &QPushButton::clicked, this, &MainWindow::saveCsv);
+        recordBtn = new QPushButton("Начать запись");
+        connect(recordBtn, &QPushButton::clicked, this, &MainWindow::toggleRecording);
         dataLayout->addWidget(saveJsonBtn);
         dataLayout->addWidget(saveCsvBtn);
+        dataLayout->addWidget(recordBtn);
         dataGroup->setLayout(dataLayout);
 
         mainLayout->addWidget(connectionGroup);
@@ -574,35 +622,18 @@ private:
         isConnected = false;
     }
 
-    class SensorDataEvent : public QEvent {
-    public:
-        SensorDataEvent(const SensorData& data) : QEvent(Type::User), sensorData(data) {}
-        SensorData sensorData;
-    };
-
-    bool event(QEvent* event) override {
-        if (event->type() == QEvent::User) {
-            auto* sensorEvent = static_cast<SensorDataEvent*>(event);
-            qDebug() << "[DEBUG] SensorDataEvent received: accel=("
-                     << sensorEvent->sensorData.accel.x << ", "
-                     << sensorEvent->sensorData.accel.y << ", "
-                     << sensorEvent->sensorData.accel.z << ")";
-            sensorDataWidget->updateData(&sensorEvent->sensorData);
-            return true;
-        }
-        return QMainWindow::event(event);
-    }
-
     QComboBox* deviceCombo;
     QPushButton* scanBtn;
     QPushButton* connectBtn;
     QPushButton* disconnectBtn;
+    QPushButton* recordBtn;
     QLabel* statusLabel;
     QTabWidget* tabWidget;
     SensorDataWidget* sensorDataWidget;
     ControlPanel* controlPanel;
     QTextEdit* logWidget;
     bool isConnected;
+    bool isRecording = false;
 };
 
 int main(int argc, char* argv[]) {
@@ -1,39 +1,240 @@
 #include "qcustomplot.h"
 #include <QPainter>
 #include <QPaintEvent>
-#include <QDebug>
-#include <QPainterPath>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// First point in [lo, hi) for which `before` is false; keys are ascending
+template <typename Before>
+int partitionPoint(const QCPDataRing& data, int lo, int hi, Before before) {
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (before(data.key(mid))) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// First point in [lo, hi) with a key not below `key`
+int lowerBound(const QCPDataRing& data, double key, int lo, int hi) {
+    return partitionPoint(data, lo, hi, [key](double k) { return k < key; });
+}
+
+// First point in [lo, hi) with a key above `key`
+int upperBound(const QCPDataRing& data, double key, int lo, int hi) {
+    return partitionPoint(data, lo, hi, [key](double k) { return k <= key; });
+}
+
+// Maps keys/values to pixels
+struct PlotTransform {
+    double left, xScale, xLower;
+    double bottom, yScale, yLower;
+
+    double x(double key) const { return left + (key - xLower) * xScale; }
+    double key(double x) const { return xLower + (x - left) / xScale; }
+    double y(double value) const { return bottom - (value - yLower) * yScale; }
+};
+
+// Points [begin, end) as a polyline of at most four vertices per pixel
+// column: the first, lowest, highest and last point of the column, the
+// extremes in the order they occur. Every spike survives. Columns are found
+// by binary search and their extremes come mostly from block summaries, so
+// a million points cost little more than a thousand.
+void decimate(const QCPDataRing& data, int begin, int end, const PlotTransform& t, QPolygonF& out) {
+    out.clear();
+    for (int first = begin; first < end;) {
+        const double column = std::floor(t.x(data.key(first)));
+        const int next = qMax(lowerBound(data, t.key(column + 1), first + 1, end), first + 1);
+        int minAt, maxAt;
+        data.extremes(first, next, minAt, maxAt);
+        out.append(QPointF(column, t.y(data.value(first))));
+        if (minAt != maxAt) {
+            out.append(QPointF(column, t.y(data.value(qMin(minAt, maxAt)))));
+            out.append(QPointF(column, t.y(data.value(qMax(minAt, maxAt)))));
+        }
+        out.append(QPointF(column, t.y(data.value(next - 1))));
+        first = next;
+    }
+}
+
+// Points [begin, end) of `graph` as one polyline, decimated when there are
+// more than four per pixel of `width`
+void drawGraph(QPainter& painter, const QCPGraph& graph, int begin, int end, const PlotTransform& t, double width,
+               QPolygonF& polyline) {
+    const QCPDataRing& data = *graph.data();
+    if (end - begin <= 4 * width) {
+        polyline.clear();
+        for (int i = begin; i < end; ++i) {
+            polyline.append(QPointF(t.x(data.key(i)), t.y(data.value(i))));
+        }
+    } else {
+        decimate(data, begin, end, t, polyline);
+    }
+    painter.setPen(graph.pen());
+    painter.drawPolyline(polyline);
+}
+
+// Move the image `pixels` device pixels to the left, clearing the right edge
+void shiftLeft(QImage& image, int pixels) {
+    const int width = image.width();
+    if (pixels >= width) {
+        image.fill(Qt::transparent);
+        return;
+    }
+    for (int y = 0; y < image.height(); ++y) {
+        quint32* line = reinterpret_cast<quint32*>(image.scanLine(y));
+        std::memmove(line, line + pixels, (width - pixels) * sizeof(quint32));
+        std::fill(line + width - pixels, line + width, 0u);
+    }
+}
+
+} // namespace
 
 QCPAxis::QCPAxis(QCustomPlot* parent, AxisType type)
     : QObject(parent), mParent(parent), mAxisType(type), mRange(0, 0), mLabel("") {}
 
-void QCPAxis::setLabel(const QString& str) { mLabel = str; }
+void QCPAxis::setLabel(const QString& str) {
+    mLabel = str;
+    mParent->invalidateLayers();
+}
 QString QCPAxis::label() const { return mLabel; }
 
 void QCPAxis::setRange(double lower, double upper) { mRange = QCPRange(lower, upper); }
 QCPRange QCPAxis::range() const { return mRange; }
 
+QCPDataRing::QCPDataRing(int capacity)
+    : mMask(0), mStart(0), mSize(0), mGeneration(0) {
+    setCapacity(capacity);
+}
+
+void QCPDataRing::setCapacity(int capacity) {
+    int rounded = 1;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+    mKeys = QVector<double>(capacity > 0 ? rounded : 0);
+    mValues = QVector<double>(mKeys.size());
+    mBlocks = QVector<Block>(mKeys.size() / kBlockSize);
+    mMask = mKeys.isEmpty() ? 0 : mKeys.size() - 1;
+    clear();
+}
+
+void QCPDataRing::add(double key, double value) {
+    if (mKeys.isEmpty()) {
+        return;
+    }
+    const int slot = (mStart + mSize) & mMask;
+    mKeys[slot] = key;
+    mValues[slot] = value;
+    if (!mBlocks.isEmpty()) {
+        // Slots are written in order, so the first slot of a block starts it afresh
+        Block& block = mBlocks[slot / kBlockSize];
+        const int offset = slot % kBlockSize;
+        if (offset == 0 || value < block.min) {
+            block.min = value;
+            block.minOffset = offset;
+        }
+        if (offset == 0 || value > block.max) {
+            block.max = value;
+            block.maxOffset = offset;
+        }
+    }
+    if (mSize == mKeys.size()) {
+        mStart = (mStart + 1) & mMask; // Overwrote the oldest
+    } else {
+        ++mSize;
+    }
+}
+
+void QCPDataRing::removeBefore(double key) {
+    while (mSize > 0 && mKeys[mStart] < key) {
+        mStart = (mStart + 1) & mMask;
+        --mSize;
+    }
+}
+
+void QCPDataRing::extremes(int begin, int end, int& minAt, int& maxAt) const {
+    minAt = maxAt = begin;
+    double minValue = value(begin);
+    double maxValue = minValue;
+    auto consider = [&](int i, double v) {
+        if (v < minValue) {
+            minValue = v;
+            minAt = i;
+        }
+        if (v > maxValue) {
+            maxValue = v;
+            maxAt = i;
+        }
+    };
+    int i = begin;
+    if (!mBlocks.isEmpty()) {
+        for (; i < end && ((mStart + i) & mMask) % kBlockSize != 0; ++i) {
+            consider(i, value(i));
+        }
+        // Every slot of a block inside the range was written after the
+        // block's first slot, so its summary covers exactly these points
+        for (; end - i >= kBlockSize; i += kBlockSize) {
+            const Block& block = mBlocks[((mStart + i) & mMask) / kBlockSize];
+            consider(i + block.minOffset, block.min);
+            consider(i + block.maxOffset, block.max);
+        }
+    }
+    for (; i < end; ++i) {
+        consider(i, value(i));
+    }
+}
+
+void QCPDataRing::clear() {
+    mStart = 0;
+    mSize = 0;
+    ++mGeneration;
+}
+
 QCPGraph::QCPGraph(QCustomPlot* parent)
     : QObject(parent), mParent(parent) {}
 
 void QCPGraph::setData(const QVector<double>& keys, const QVector<double>& values) {
-    mKeys = keys;
-    mValues = values;
+    const int count = qMin(keys.size(), values.size());
+    if (count > mData.capacity()) {
+        mData.setCapacity(count);
+    }
+    mData.clear();
+    for (int i = 0; i < count; ++i) {
+        mData.add(keys[i], values[i]);
+    }
 }
 
-const QVector<double>& QCPGraph::keys() const { return mKeys; }
-const QVector<double>& QCPGraph::values() const { return mValues; }
+void QCPGraph::addData(double key, double value) { mData.add(key, value); }
+
+QCPDataRing* QCPGraph::data() { return &mData; }
+const QCPDataRing* QCPGraph::data() const { return &mData; }
 
-void QCPGraph::setPen(const QPen& pen) { mPen = pen; }
+void QCPGraph::setPen(const QPen& pen) {
+    mPen = pen;
+    mParent->invalidateLayers();
+}
 QPen QCPGraph::pen() const { return mPen; }
 
-void QCPGraph::setName(const QString& name) { mName = name; }
+void QCPGraph::setName(const QString& name) {
+    mName = name;
+    mParent->invalidateLayers();
+}
 QString QCPGraph::name() const { return mName; }
 
 QCPLegend::QCPLegend(QCustomPlot* parent)
     : QObject(parent), mParent(parent), mVisible(false) {}
 
-void QCPLegend::setVisible(bool visible) { mVisible = visible; }
+void QCPLegend::setVisible(bool visible) {
+    mVisible = visible;
+    mParent->invalidateLayers();
+}
 bool QCPLegend::visible() const { return mVisible; }
 
 QCustomPlot::QCustomPlot(QWidget* parent)
@@ -42,11 +243,14 @@ QCustomPlot::QCustomPlot(QWidget* parent)
     yAxis = new QCPAxis(this, QCPAxis::atLeft);
     legend = new QCPLegend(this);
     setMinimumSize(300, 200);
+    // Every pixel comes from the layers
+    setAttribute(Qt::WA_OpaquePaintEvent);
 }
 
 QCPGraph* QCustomPlot::addGraph() {
     QCPGraph* graph = new QCPGraph(this);
     mGraphs.append(graph);
+    invalidateLayers();
     return graph;
 }
 
@@ -58,17 +262,24 @@ void QCustomPlot::replot() {
     update();
 }
 
-void QCustomPlot::paintEvent(QPaintEvent* event) {
-    Q_UNUSED(event);
+void QCustomPlot::invalidateLayers() {
+    mStaticValid = false;
+    mDataValid = false;
+}
 
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+QRectF QCustomPlot::plotArea() const {
+    return QRectF(30, 10, width() - 40, height() - 30);
+}
 
-    // Draw background
-    painter.fillRect(rect(), Qt::white);
+void QCustomPlot::renderStaticLayers() {
+    const qreal ratio = devicePixelRatioF();
+    const QRectF plotArea = this->plotArea();
 
-    // Calculate plot area with adjusted margins
-    QRectF plotArea(30, 10, width() - 40, height() - 30);
+    mBackground = QPixmap(size() * ratio);
+    mBackground.setDevicePixelRatio(ratio);
+    mBackground.fill(Qt::white);
+    QPainter painter(&mBackground);
+    painter.setRenderHint(QPainter::Antialiasing);
 
     // Draw axes
     painter.setPen(Qt::black);
@@ -88,32 +299,16 @@ void QCustomPlot::paintEvent(QPaintEvent* event) {
         painter.drawText(0, 0, yAxis->label());
         painter.resetTransform();
     }
+    painter.end();
 
-    // Draw graphs
-    for (QCPGraph* graph : mGraphs) {
-        const QVector<double>& keys = graph->keys();
-        const QVector<double>& values = graph->values();
-        if (keys.isEmpty() || values.size() != keys.size()) {
-            qDebug() << "[DEBUG] Skipping graph due to empty or mismatched data";
-            continue;
-        }
-
-        painter.setPen(graph->pen());
-        QPainterPath path;
-        for (int i = 0; i < keys.size(); ++i) {
-            double x = plotArea.left() + (keys[i] - xAxis->range().lower) / (xAxis->range().upper - xAxis->range().lower) * plotArea.width();
-            double y = plotArea.bottom() - (values[i] - yAxis->range().lower) / (yAxis->range().upper - yAxis->range().lower) * plotArea.height();
-            if (i == 0) {
-                path.moveTo(x, y);
-            } else {
-                path.lineTo(x, y);
-            }
-        }
-        painter.drawPath(path);
-    }
+    mForeground = QPixmap(size() * ratio);
+    mForeground.setDevicePixelRatio(ratio);
+    mForeground.fill(Qt::transparent);
 
     // Draw legend if visible
     if (legend->visible()) {
+        painter.begin(&mForeground);
+        painter.setRenderHint(QPainter::Antialiasing);
         int y = 20;
         for (QCPGraph* graph : mGraphs) {
             if (graph->name().isEmpty()) continue;
@@ -123,5 +318,104 @@ void QCustomPlot::paintEvent(QPaintEvent* event) {
             painter.drawText(width() - 75, y + 5, graph->name());
             y += 20;
         }
+        painter.end();
+    }
+    mStaticValid = true;
+}
+
+bool QCustomPlot::renderDataLayer(const QRectF& plotArea) {
+    const QCPRange xRange = xAxis->range();
+    const QCPRange yRange = yAxis->range();
+    const qreal ratio = devicePixelRatioF();
+    const QSize pixels = (plotArea.size() * ratio).toSize();
+    if (xRange.upper <= xRange.lower || yRange.upper <= yRange.lower || pixels.isEmpty()) {
+        mDataValid = false;
+        return false;
     }
-}
\ No newline at end of file
+    const double span = xRange.upper - xRange.lower;
+    const double xScale = plotArea.width() / span;
+    const double yScale = plotArea.height() / (yRange.upper - yRange.lower);
+
+    // Anything but the x range moving forward within the width, or points
+    // being appended and trimmed, needs the whole layer redrawn
+    mDrawn.resize(mGraphs.size());
+    bool full = !mDataValid || mDataLayer.size() != pixels || mDataLayer.devicePixelRatio() != ratio ||
+                yRange.lower != mDataYRange.lower || yRange.upper != mDataYRange.upper ||
+                std::fabs(span - mDataSpan) > span * 1e-9 || xRange.lower < mDataOrigin ||
+                (xRange.lower - mDataOrigin) * xScale >= plotArea.width();
+    for (int i = 0; i < mGraphs.size() && !full; ++i) {
+        const QCPDataRing* data = mGraphs[i]->data();
+        const DrawnGraph& drawn = mDrawn[i];
+        full = drawn.generation != data->generation() ||
+               (drawn.drawn && (data->isEmpty() || drawn.lastKey < data->key(0)));
+    }
+
+    if (full) {
+        if (mDataLayer.size() != pixels) {
+            mDataLayer = QImage(pixels, QImage::Format_ARGB32_Premultiplied);
+        }
+        mDataLayer.setDevicePixelRatio(ratio);
+        mDataLayer.fill(Qt::transparent);
+        mDataOrigin = xRange.lower;
+        mDataSpan = span;
+        mDataYRange = yRange;
+        for (int i = 0; i < mGraphs.size(); ++i) {
+            mDrawn[i] = DrawnGraph();
+        }
+    } else {
+        // Scroll by whole device pixels; the origin follows, so old and new
+        // points stay aligned (the view may lag the range by under a pixel)
+        const int shift = static_cast<int>(std::floor((xRange.lower - mDataOrigin) * xScale * ratio));
+        if (shift > 0) {
+            shiftLeft(mDataLayer, shift);
+            mDataOrigin += shift / (xScale * ratio);
+        }
+    }
+
+    const PlotTransform transform = {
+        0.0, xScale, mDataOrigin,
+        plotArea.height(), yScale, yRange.lower,
+    };
+    QPainter painter(&mDataLayer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (int i = 0; i < mGraphs.size(); ++i) {
+        const QCPDataRing* data = mGraphs[i]->data();
+        DrawnGraph& drawn = mDrawn[i];
+        drawn.generation = data->generation();
+        if (data->isEmpty()) {
+            continue;
+        }
+        // New points continue the line from the newest one already drawn;
+        // a fresh layer takes every visible point plus one on each side so
+        // the line reaches the edges
+        const int begin = drawn.drawn ? lowerBound(*data, drawn.lastKey, 0, data->size())
+                                      : qMax(lowerBound(*data, mDataOrigin, 0, data->size()) - 1, 0);
+        const int end = qMin(lowerBound(*data, xRange.upper, 0, data->size()) + 1, data->size());
+        drawGraph(painter, *mGraphs[i], begin, end, transform, plotArea.width(), mPolyline);
+
+        // Points past the right edge are drawn again once they scroll in
+        const int inside = upperBound(*data, xRange.upper, 0, data->size()) - 1;
+        if (inside >= 0) {
+            drawn.drawn = true;
+            drawn.lastKey = data->key(inside);
+        }
+    }
+    mDataValid = true;
+    return true;
+}
+
+void QCustomPlot::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+
+    if (!mStaticValid || mBackground.size() != size() * devicePixelRatioF()) {
+        renderStaticLayers();
+    }
+
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, mBackground);
+    const QRectF plotArea = this->plotArea();
+    if (renderDataLayer(plotArea)) {
+        painter.drawImage(plotArea.topLeft(), mDataLayer);
+    }
+    painter.drawPixmap(0, 0, mForeground);
+}
@@ -3,7 +3,10 @@
 
 #include <QWidget>
 #include <QObject>
+#include <QImage>
 #include <QPen>
+#include <QPixmap>
+#include <QPolygonF>
 #include <QVector>
 
 struct QCPRange {
@@ -13,6 +16,52 @@ struct QCPRange {
 
 class QCustomPlot;
 
+// Fixed-capacity ring of key/value points, oldest first. Adding to a full
+// ring overwrites the oldest point, so appending and trimming cost O(1) per
+// point however long the window is; nothing is copied or reallocated. Keys
+// must be ascending, as for a time series.
+class QCPDataRing {
+public:
+    explicit QCPDataRing(int capacity = 0);
+
+    // Rounded up to a power of two; drops all points
+    void setCapacity(int capacity);
+    int capacity() const { return mKeys.size(); }
+    int size() const { return mSize; }
+    bool isEmpty() const { return mSize == 0; }
+
+    void add(double key, double value);
+    // Drop the oldest points with keys below `key`
+    void removeBefore(double key);
+    void clear();
+    // Changes whenever points are replaced rather than appended or trimmed
+    quint64 generation() const { return mGeneration; }
+
+    // Point i, 0 being the oldest
+    double key(int i) const { return mKeys[(mStart + i) & mMask]; }
+    double value(int i) const { return mValues[(mStart + i) & mMask]; }
+    // Indices of the lowest and highest value among points [begin, end);
+    // whole blocks are answered from their summaries
+    void extremes(int begin, int end, int& minAt, int& maxAt) const;
+
+private:
+    // Lowest and highest value of each kBlockSize aligned slots, kept up to
+    // date by add()
+    static constexpr int kBlockSize = 64;
+    struct Block {
+        double min, max;
+        int minOffset, maxOffset;
+    };
+
+    QVector<double> mKeys;
+    QVector<double> mValues;
+    QVector<Block> mBlocks;
+    int mMask;
+    int mStart;
+    int mSize;
+    quint64 mGeneration;
+};
+
 class QCPAxis : public QObject {
     Q_OBJECT
 public:
@@ -35,9 +84,12 @@ class QCPGraph : public QObject {
     Q_OBJECT
 public:
     QCPGraph(QCustomPlot* parent);
+    // Replaces the points; grows the ring if they do not fit
     void setData(const QVector<double>& keys, const QVector<double>& values);
-    const QVector<double>& keys() const;   // Changed to return const reference
-    const QVector<double>& values() const; // Changed to return const reference
+    void addData(double key, double value);
+    // The graph draws straight from this ring
+    QCPDataRing* data();
+    const QCPDataRing* data() const;
     void setPen(const QPen& pen);
     QPen pen() const;
     void setName(const QString& name);
@@ -45,8 +97,7 @@ public:
 
 private:
     QCustomPlot* mParent;
-    QVector<double> mKeys;
-    QVector<double> mValues;
+    QCPDataRing mData;
     QPen mPen;
     QString mName;
 };
@@ -80,7 +131,42 @@ protected:
     void paintEvent(QPaintEvent* event) override;
 
 private:
+    friend class QCPAxis;
+    friend class QCPGraph;
+    friend class QCPLegend;
+
+    // What the data layer holds for one graph
+    struct DrawnGraph {
+        quint64 generation = 0;
+        bool drawn = false;
+        double lastKey = 0; // Newest point drawn inside the x range
+    };
+
+    // Labels, pens or legend changed: rebuild every layer on the next paint
+    void invalidateLayers();
+    QRectF plotArea() const;
+    void renderStaticLayers();
+    // False when the ranges leave nothing to draw
+    bool renderDataLayer(const QRectF& plotArea);
+
     QVector<QCPGraph*> mGraphs;
+    QPolygonF mPolyline; // Reused by every paint
+
+    // Background, axes and labels below the data, legend above it; they
+    // depend only on the widget size and the texts, not on the data
+    QPixmap mBackground;
+    QPixmap mForeground;
+    bool mStaticValid = false;
+
+    // Graphs of the plot area. When only the x range moves forward by less
+    // than the width, the image is shifted by whole device pixels and just
+    // the points that arrived since the last paint are drawn.
+    QImage mDataLayer;
+    bool mDataValid = false;
+    double mDataOrigin = 0;     // Key at the layer's left edge
+    double mDataSpan = 0;       // x range width the layer was drawn for
+    QCPRange mDataYRange;
+    QVector<DrawnGraph> mDrawn; // Parallel to mGraphs
 };
 
 #endif // QCUSTOMPLOT_H
\ No newline at end of file
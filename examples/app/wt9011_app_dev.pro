@@ -4,11 +4,53 @@ CONFIG += c++17
 SOURCES += \
     main.cpp \
     wt9011_interface.cpp \
-    qcustomplot.cpp
+    qcustomplot.cpp \
+    ../../dll_lib/wt9011_loop.cpp \
+    ../../dll_lib/wt9011_session.cpp \
+    ../../dll_lib/wt9011_recorder.cpp \
+    ../../dll_lib/wt9011_mapped_file.cpp \
+    ../../dll_lib/wt9011_capture.cpp \
+    ../../dll_lib/wt9011_replay.cpp \
+    ../../dll_lib/wt9011_sim.cpp \
+    ../../dll_lib/wt9011_stats.cpp \
+    ../../dll_lib/wt9011_log.cpp \
+    ../../dll_lib/wt9011_dispatch.cpp \
+    ../../dll_lib/wt9011_registers.cpp \
+    ../../dll_lib/wt9011_fusion.cpp \
+    ../../dll_lib/wt9011_filters.cpp \
+    ../../dll_lib/wt9011_window_stats.cpp \
+    ../../dll_lib/wt9011_spectrum.cpp
 
 HEADERS += \
     wt9011_interface.h \
-    qcustomplot.h
+    qcustomplot.h \
+    ../../dll_lib/wt9011_types.h \
+    ../../dll_lib/wt9011_decoder.h \
+    ../../dll_lib/wt9011_commands.h \
+    ../../dll_lib/wt9011_assembler.h \
+    ../../dll_lib/wt9011_batch.h \
+    ../../dll_lib/wt9011_api.h \
+    ../../dll_lib/wt9011_loop.h \
+    ../../dll_lib/wt9011_clock.h \
+    ../../dll_lib/wt9011_ring.h \
+    ../../dll_lib/wt9011_recorder.h \
+    ../../dll_lib/wt9011_mapped_file.h \
+    ../../dll_lib/wt9011_source.h \
+    ../../dll_lib/wt9011_capture.h \
+    ../../dll_lib/wt9011_replay.h \
+    ../../dll_lib/wt9011_sim.h \
+    ../../dll_lib/wt9011_stats.h \
+    ../../dll_lib/wt9011_log.h \
+    ../../dll_lib/wt9011_dispatch.h \
+    ../../dll_lib/wt9011_registers.h \
+    ../../dll_lib/wt9011_fusion.h \
+    ../../dll_lib/wt9011_filters.h \
+    ../../dll_lib/wt9011_window_stats.h \
+    ../../dll_lib/wt9011_spectrum.h \
+    ../../dll_lib/wt9011_session.h
+
+# Общий нативный код библиотеки
+INCLUDEPATH += ../../dll_lib
 
 # Python config
 PYTHON_VER = 3.12
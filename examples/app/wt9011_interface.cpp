@@ -5,56 +5,38 @@
 #include <string>
 #include <vector>
 #include <memory>
-#include <iostream>
 #include <thread>
 #include <chrono>
 #include <Python.h>
+#include "wt9011_decoder.h"
+#include "wt9011_batch.h"
+#include "wt9011_commands.h"
+#include "wt9011_log.h"
+#include "wt9011_loop.h"
+#include "wt9011_session.h"
+#include "wt9011_sim.h"
 
 namespace py = pybind11;
 
 static std::unique_ptr<py::scoped_interpreter> guard;
-static py::object ble_manager_instance;
+static std::unique_ptr<py::gil_scoped_release> gil_release;
+static py::object ble_manager_instance; // только для сканирования
 static py::object parser_class;
-static py::object commands_class;
-static DataCallback global_callback = nullptr;
 
-void run_coroutine_void(py::object coro) {
-    try {
-        py::gil_scoped_acquire acquire;
-        py::module_ asyncio = py::module_::import("asyncio");
-
-        py::object loop;
-        try {
-            loop = asyncio.attr("get_event_loop")();
-        } catch (const py::error_already_set&) {
-            loop = asyncio.attr("new_event_loop")();
-            asyncio.attr("set_event_loop")(loop);
-        }
+// Сессия, с которой работает API для одного устройства (wt9011_connect, wt9011_receive, ...)
+static wt9011_session* default_session = nullptr;
 
-        loop.attr("run_until_complete")(coro);
-    } catch (const py::error_already_set& e) {
-        std::cerr << "[PYTHON ERROR] " << e.what() << std::endl;
-        throw;
-    }
-}
+// Запись, запущенная wt9011_record_start
+static wt9011_recorder* default_recorder = nullptr;
 
+// Корутины выполняются в постоянном цикле asyncio на отдельном потоке
 template<typename T>
 T run_coroutine(py::object coro) {
     try {
         py::gil_scoped_acquire acquire;
-        py::module_ asyncio = py::module_::import("asyncio");
-
-        py::object loop;
-        try {
-            loop = asyncio.attr("get_event_loop")();
-        } catch (const py::error_already_set&) {
-            loop = asyncio.attr("new_event_loop")();
-            asyncio.attr("set_event_loop")(loop);
-        }
-
-        return loop.attr("run_until_complete")(coro).cast<T>();
+        return wt9011::io_loop().run(coro).cast<T>();
     } catch (const py::error_already_set& e) {
-        std::cerr << "[PYTHON ERROR] " << e.what() << std::endl;
+        WT9011_LOG_ERROR("Python: %s", e.what());
         throw;
     }
 }
@@ -75,54 +57,80 @@ extern "C" SensorData convert_to_sensor_data(py::dict data) {
         result.angle.pitch = data["angle"]["pitch"].cast<float>();
         result.angle.yaw   = data["angle"]["yaw"].cast<float>();
     } catch (const py::cast_error& e) {
-        std::cerr << "[ERROR] Failed to convert sensor data: " << e.what() << std::endl;
+        WT9011_LOG_ERROR("Failed to convert sensor data: %s", e.what());
     }
 
     return result;
 }
 
+extern "C" int wt9011_decode_batch(const unsigned char* frames, int count, const SensorDataSoA* out) {
+    if (!frames || !out || count <= 0) {
+        return 0;
+    }
+    return static_cast<int>(wt9011::decode_frames_soa(frames, static_cast<std::size_t>(count), *out));
+}
 
 extern "C" bool wt9011_init() {
     try {
-        std::cout << "[INFO] Initializing Python..." << std::endl;
+        WT9011_LOG_INFO("Initializing Python...");
 
         if (!guard) {
             guard = std::make_unique<py::scoped_interpreter>();
         }
 
-        std::cout << "[INFO] Python initialized." << std::endl;
+        WT9011_LOG_INFO("Python initialized.");
 
-        py::module_::import("sys").attr("path").attr("insert")(0, ".");
+        {
+            py::gil_scoped_acquire acquire;
+            py::module_::import("sys").attr("path").attr("insert")(0, ".");
+
+            py::module_ ble_manager_module = py::module_::import("ble_manager");
+            ble_manager_instance = ble_manager_module.attr("ble_manager_instance");
+            wt9011::set_ble_manager_class(ble_manager_module.attr("BLEManager"));
 
-        py::module_ ble_manager_module = py::module_::import("ble_manager");
-        ble_manager_instance = ble_manager_module.attr("ble_manager_instance");
+            parser_class = py::module_::import("sensor_parser").attr("WT9011Parser");
 
-        parser_class = py::module_::import("sensor_parser").attr("WT9011Parser");
-        commands_class = py::module_::import("sensor_commands").attr("WT9011Commands");
+            wt9011::io_loop().start();
+        }
+
+        // Отпускаем GIL, пока библиотека простаивает, чтобы поток цикла asyncio работал
+        if (!gil_release) {
+            gil_release = std::make_unique<py::gil_scoped_release>();
+        }
 
-        std::cout << "[INFO] All modules imported successfully." << std::endl;
+        WT9011_LOG_INFO("All modules imported successfully.");
         return true;
 
     } catch (const py::error_already_set& e) {
-        std::cerr << "[PYTHON ERROR] " << e.what() << std::endl;
+        WT9011_LOG_ERROR("Python: %s", e.what());
         return false;
     } catch (const std::exception& e) {
-        std::cerr << "[EXCEPTION] " << e.what() << std::endl;
+        WT9011_LOG_ERROR("%s", e.what());
         return false;
     } catch (...) {
-        std::cerr << "[UNKNOWN ERROR] Failed to initialize Python" << std::endl;
+        WT9011_LOG_ERROR("Failed to initialize Python");
         return false;
     }
 }
 
 extern "C" bool wt9011_scan(DeviceInfo* devices, int* count, float timeout) {
+    // Симулированные устройства (WT9011_SIM) идут первыми и не требуют радио
+    const int max_count = *count;
+    int found = 0;
+    for (const DeviceInfo& device : wt9011::sim_devices()) {
+        if (found < max_count) {
+            devices[found++] = device;
+            WT9011_LOG_INFO("Simulated device: %s (%s)", device.name.c_str(), device.address.c_str());
+        }
+    }
+
     try {
-        std::cout << "[INFO] Starting BLE scan with timeout " << timeout << "s" << std::endl;
+        WT9011_LOG_INFO("Starting BLE scan with timeout %gs", timeout);
 
         if (!ble_manager_instance) {
-            std::cerr << "[ERROR] BLE manager instance not initialized" << std::endl;
-            *count = 0;
-            return false;
+            WT9011_LOG_ERROR("BLE manager instance not initialized");
+            *count = found;
+            return found > 0;
         }
 
         py::gil_scoped_acquire acquire;
@@ -131,283 +139,299 @@ extern "C" bool wt9011_scan(DeviceInfo* devices, int* count, float timeout) {
             ble_manager_instance.attr("scan")(timeout)
         );
 
-        std::cout << "[INFO] Scan completed, found " << result.size() << " devices" << std::endl;
+        WT9011_LOG_INFO("Scan completed, found %zu devices", result.size());
 
-        int max_count = *count;
-        *count = std::min(static_cast<int>(result.size()), max_count);
-
-        for (int i = 0; i < *count; ++i) {
-            devices[i].name = result[i]["name"].cast<std::string>();
-            devices[i].address = result[i]["address"].cast<std::string>();
-            std::cout << "[INFO] Device " << i << ": " << devices[i].name
-                      << " (" << devices[i].address << ")" << std::endl;
+        for (size_t i = 0; i < result.size() && found < max_count; ++i, ++found) {
+            devices[found].name = result[i]["name"].cast<std::string>();
+            devices[found].address = result[i]["address"].cast<std::string>();
+            WT9011_LOG_INFO("Device %d: %s (%s)", found, devices[found].name.c_str(), devices[found].address.c_str());
         }
 
+        *count = found;
         return *count > 0;
 
     } catch (const py::error_already_set& e) {
-        std::cerr << "[PYTHON ERROR] Scan failed: " << e.what() << std::endl;
-        *count = 0;
-        return false;
+        WT9011_LOG_ERROR("Python: scan failed: %s", e.what());
+        *count = found;
+        return found > 0;
     } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Scan failed: " << e.what() << std::endl;
-        *count = 0;
-        return false;
+        WT9011_LOG_ERROR("Scan failed: %s", e.what());
+        *count = found;
+        return found > 0;
     }
 }
 
 extern "C" bool wt9011_connect(const char* address) {
-    try {
-        if (!ble_manager_instance) {
-            std::cerr << "[ERROR] BLE manager instance not initialized" << std::endl;
-            return false;
-        }
+    if (default_session) {
+        wt9011_close(default_session);
+        default_session = nullptr;
+    }
 
-        std::cout << "[INFO] Connecting to " << address << std::endl;
-        py::gil_scoped_acquire acquire;
+    WT9011_LOG_INFO("Connecting to %s", address);
 
-        int max_attempts = 3;
-        for (int attempt = 1; attempt <= max_attempts; ++attempt) {
-            try {
-                run_coroutine_void(ble_manager_instance.attr("connect")(address));
-                std::cout << "[INFO] Connected to " << address << " on attempt " << attempt << std::endl;
-                return true;
-            } catch (const py::error_already_set& e) {
-                std::cerr << "[PYTHON ERROR] Connection attempt " << attempt << " failed: " << e.what() << std::endl;
-                if (attempt == max_attempts) throw;
-                std::this_thread::sleep_for(std::chrono::milliseconds(2000));
-            }
+    int max_attempts = 3;
+    for (int attempt = 1; attempt <= max_attempts; ++attempt) {
+        default_session = wt9011_open(address);
+        if (default_session) {
+            WT9011_LOG_INFO("Connected to %s on attempt %d", address, attempt);
+            return true;
+        }
+        WT9011_LOG_ERROR("Connection attempt %d failed", attempt);
+        if (attempt < max_attempts) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2000));
         }
-    } catch (const py::error_already_set& e) {
-        std::cerr << "[PYTHON ERROR] Connection failed: " << e.what() << std::endl;
-        return false;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Connection failed: " << e.what() << std::endl;
-        return false;
     }
+    WT9011_LOG_ERROR("Connection failed");
     return false;
 }
 
-extern "C" void data_callback_wrapper(py::object data) {
-    try {
-        py::gil_scoped_acquire acquire;
-
-        py::bytearray byte_array = data.cast<py::bytearray>();
-        char* buffer = PyByteArray_AsString(byte_array.ptr());
-        Py_ssize_t length = PyByteArray_Size(byte_array.ptr());
+// Приводят callback API одного устройства к сигнатуре callback сессии
+static void default_data_callback(wt9011_session*, const SensorSample* sample, void* user) {
+    reinterpret_cast<DataCallback>(user)(&sample->data);
+}
 
-        // Логирование сырых данных
-        std::string hex_dump;
-        for (Py_ssize_t i = 0; i < length; ++i) {
-            char buf[4];
-            snprintf(buf, sizeof(buf), "%02X ", (unsigned char)buffer[i]);
-            hex_dump += buf;
-        }
-        std::cerr << "[BLE] Received " << length << " bytes: " << hex_dump << std::endl;
+static void default_sample_callback(wt9011_session*, const SensorSample* sample, void* user) {
+    reinterpret_cast<SampleCallback>(user)(sample);
+}
 
-        // Парсинг
-        auto parsed = parser_class.attr("parse")(data);
-        if (parsed.is_none()) {
-            std::cerr << "[ERROR] Parser returned None" << std::endl;
-            return;
-        }
+static bool start_receive(SessionSampleCallback trampoline, void* callback) {
+    if (!default_session) {
+        WT9011_LOG_ERROR("Not connected");
+        return false;
+    }
 
-        // Конвертация и вызов callback
-        SensorData sensor_data = convert_to_sensor_data(parsed);
-        if (global_callback) {
-            std::cerr << "[DEBUG] Sending data to callback" << std::endl;
-            global_callback(&sensor_data);
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "[EXCEPTION] In callback: " << e.what() << std::endl;
+    bool ok = callback
+        ? wt9011_session_receive(default_session, trampoline, callback)
+        : wt9011_session_receive(default_session, nullptr, nullptr);
+    if (ok) {
+        WT9011_LOG_INFO("Started receiving data");
+    } else {
+        WT9011_LOG_ERROR("Receive failed");
     }
+    return ok;
 }
 
 extern "C" bool wt9011_receive(DataCallback callback) {
-    try {
-        if (!ble_manager_instance) {
-            std::cerr << "[ERROR] BLE manager instance not initialized" << std::endl;
-            return false;
-        }
-
-        global_callback = callback;
-        py::gil_scoped_acquire acquire;
-
-        run_coroutine_void(ble_manager_instance.attr("receive")(
-            py::cpp_function(data_callback_wrapper)
-        ));
-
-        std::cout << "[INFO] Started receiving data" << std::endl;
-        return true;
+    return start_receive(default_data_callback, reinterpret_cast<void*>(callback));
+}
 
-    } catch (const py::error_already_set& e) {
-        std::cerr << "[PYTHON ERROR] Receive failed: " << e.what() << std::endl;
-        global_callback = nullptr;
-        return false;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Receive failed: " << e.what() << std::endl;
-        global_callback = nullptr;
-        return false;
-    }
+extern "C" bool wt9011_receive_samples(SampleCallback callback) {
+    return start_receive(default_sample_callback, reinterpret_cast<void*>(callback));
 }
 
-extern "C" bool wt9011_send(const unsigned char* command, int length) {
-    try {
-        if (!ble_manager_instance) {
-            std::cerr << "[ERROR] BLE manager instance not initialized" << std::endl;
-            return false;
-        }
+extern "C" size_t wt9011_poll(SensorData* out, size_t max) {
+    return wt9011_session_poll(default_session, out, max);
+}
 
-        py::gil_scoped_acquire acquire;
-        std::string command_str(reinterpret_cast<const char*>(command), length);
+extern "C" size_t wt9011_poll_samples(SensorSample* out, size_t max) {
+    return wt9011_session_poll_samples(default_session, out, max);
+}
 
-        run_coroutine_void(ble_manager_instance.attr("send")(py::bytes(command_str)));
+extern "C" unsigned long long wt9011_dropped_samples() {
+    return wt9011_session_dropped_samples(default_session);
+}
 
-        std::cout << "[INFO] Sent command of length " << length << std::endl;
-        return true;
+extern "C" unsigned long long wt9011_discarded_bytes() {
+    return wt9011_session_discarded_bytes(default_session);
+}
 
-    } catch (const py::error_already_set& e) {
-        std::cerr << "[PYTHON ERROR] Send failed: " << e.what() << std::endl;
-        return false;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Send failed: " << e.what() << std::endl;
+extern "C" bool wt9011_send(const unsigned char* command, int length) {
+    if (!wt9011_session_send(default_session, command, length)) {
+        WT9011_LOG_ERROR("Send failed");
         return false;
     }
+    WT9011_LOG_DEBUG("Sent command of length %d", length);
+    return true;
 }
 
 extern "C" bool wt9011_disconnect() {
-    try {
-        if (!ble_manager_instance) {
-            std::cerr << "[ERROR] BLE manager instance not initialized" << std::endl;
-            return false;
-        }
+    if (!default_session) {
+        WT9011_LOG_ERROR("Not connected");
+        return false;
+    }
 
-        py::gil_scoped_acquire acquire;
-        run_coroutine_void(ble_manager_instance.attr("disconnect")());
+    bool ok = wt9011_close(default_session);
+    default_session = nullptr;
+    if (ok) {
+        WT9011_LOG_INFO("Disconnected");
+    } else {
+        WT9011_LOG_ERROR("Disconnect failed");
+    }
+    return ok;
+}
 
-        std::cout << "[INFO] Disconnected" << std::endl;
-        global_callback = nullptr;
-        return true;
+extern "C" bool wt9011_record_stop() {
+    if (!default_recorder) {
+        return false;
+    }
+    unsigned long long samples = wt9011_recorder_samples(default_recorder);
+    unsigned long long dropped = wt9011_recorder_dropped(default_recorder);
+    bool ok = wt9011_recorder_close(default_recorder);
+    default_recorder = nullptr;
+    if (ok) {
+        WT9011_LOG_INFO("Recording stopped: %llu samples, %llu dropped", samples, dropped);
+    } else {
+        WT9011_LOG_ERROR("Failed to finalize recording");
+    }
+    return ok;
+}
 
-    } catch (const py::error_already_set& e) {
-        std::cerr << "[PYTHON ERROR] Disconnect failed: " << e.what() << std::endl;
+extern "C" bool wt9011_record_start(const char* path) {
+    if (!default_session) {
+        WT9011_LOG_ERROR("Not connected");
         return false;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Disconnect failed: " << e.what() << std::endl;
+    }
+    wt9011_record_stop();
+    default_recorder = wt9011_recorder_open(path);
+    if (!default_recorder || !wt9011_session_record(default_session, default_recorder)) {
+        WT9011_LOG_ERROR("Failed to start recording to %s", path);
+        wt9011_record_stop();
         return false;
     }
+    WT9011_LOG_INFO("Recording to %s", path);
+    return true;
 }
 
-extern "C" bool wt9011_zeroing() {
-    try {
-        py::gil_scoped_acquire acquire;
-        py::bytes command = commands_class.attr("build_command_zeroing")();
-        run_coroutine_void(ble_manager_instance.attr("send")(command));
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Zeroing failed: " << e.what() << std::endl;
+extern "C" bool wt9011_capture_start(const char* path) {
+    if (!path || !wt9011_session_capture(default_session, path)) {
+        WT9011_LOG_ERROR("Failed to start capture");
         return false;
     }
+    WT9011_LOG_INFO("Capturing notifications to %s", path);
+    return true;
 }
 
-extern "C" bool wt9011_calibration() {
-    try {
-        py::gil_scoped_acquire acquire;
-        py::bytes command = commands_class.attr("build_command_calibration")();
-        run_coroutine_void(ble_manager_instance.attr("send")(command));
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Calibration failed: " << e.what() << std::endl;
+extern "C" bool wt9011_capture_stop() {
+    return wt9011_session_capture(default_session, nullptr);
+}
+
+extern "C" bool wt9011_replay(const char* path, double speed) {
+    wt9011_record_stop();
+    if (default_session) {
+        wt9011_close(default_session);
+    }
+    default_session = wt9011_replay_open(path, speed, false);
+    if (!default_session) {
+        WT9011_LOG_ERROR("Cannot open capture %s", path ? path : "");
         return false;
     }
+    WT9011_LOG_INFO("Replaying %s", path);
+    return true;
 }
 
-extern "C" bool wt9011_save_settings() {
-    try {
-        py::gil_scoped_acquire acquire;
-        py::bytes command = commands_class.attr("build_command_save_settings")();
-        run_coroutine_void(ble_manager_instance.attr("send")(command));
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Save settings failed: " << e.what() << std::endl;
-        return false;
+extern "C" wt9011_op* wt9011_connect_async(const char* address) {
+    if (default_session) {
+        wt9011_close(default_session);
     }
+    default_session = wt9011_session_create(address);
+    return wt9011_session_connect_async(default_session);
 }
 
-extern "C" bool wt9011_factory_reset() {
+extern "C" wt9011_op* wt9011_send_async(const unsigned char* command, int length) {
+    return wt9011_session_send_async(default_session, command, length);
+}
+
+extern "C" wt9011_op* wt9011_disconnect_async() {
     try {
+        if (!default_session) {
+            WT9011_LOG_ERROR("Not connected");
+            return nullptr;
+        }
+        if (default_session->source) {
+            return nullptr;
+        }
+        wt9011::set_session_callback(*default_session, nullptr, nullptr);
+
         py::gil_scoped_acquire acquire;
-        py::bytes command = commands_class.attr("build_command_factory_reset")();
-        run_coroutine_void(ble_manager_instance.attr("send")(command));
-        return true;
+        if (!default_session->manager) {
+            return nullptr;
+        }
+        return new wt9011_op{ wt9011::io_loop().submit(default_session->manager.attr("disconnect")()) };
     } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Factory reset failed: " << e.what() << std::endl;
-        return false;
+        WT9011_LOG_ERROR("Disconnect failed: %s", e.what());
+        return nullptr;
     }
 }
 
-extern "C" bool wt9011_sleep() {
-    try {
-        py::gil_scoped_acquire acquire;
-        py::bytes command = commands_class.attr("build_command_sleep")();
-        run_coroutine_void(ble_manager_instance.attr("send")(command));
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Sleep failed: " << e.what() << std::endl;
+// Команды собираются на этапе компиляции (wt9011_commands.h), без интерпретатора
+static bool send_command(const wt9011::Command& command, const char* name) {
+    if (!wt9011_session_send(default_session, command.bytes, static_cast<int>(wt9011::kCommandSize))) {
+        WT9011_LOG_ERROR("%s failed", name);
         return false;
     }
+    return true;
 }
 
-extern "C" bool wt9011_wakeup() {
-    try {
-        py::gil_scoped_acquire acquire;
-        py::bytes command = commands_class.attr("build_command_wakeup")();
-        run_coroutine_void(ble_manager_instance.attr("send")(command));
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Wakeup failed: " << e.what() << std::endl;
+extern "C" bool wt9011_write_register(unsigned char reg, unsigned short value) {
+    return send_command(wt9011::encode_command(reg, value), "Register write");
+}
+
+extern "C" bool wt9011_read_register(unsigned char reg, unsigned short* value, int timeout_ms) {
+    if (!wt9011_session_read_register(default_session, reg, value, timeout_ms)) {
+        WT9011_LOG_ERROR("Register 0x%02X read failed", reg);
         return false;
     }
+    return true;
+}
+
+extern "C" bool wt9011_set_windows(const double* seconds, size_t count, double max_rate_hz) {
+    return wt9011_session_set_windows(default_session, seconds, count, max_rate_hz);
+}
+
+extern "C" bool wt9011_window_stats(size_t window, WindowStats* out) {
+    return wt9011_session_window_stats(default_session, window, out);
+}
+
+extern "C" bool wt9011_zeroing() {
+    return send_command(wt9011::kCommandZeroing, "Zeroing");
+}
+
+extern "C" bool wt9011_calibration() {
+    return send_command(wt9011::kCommandCalibration, "Calibration");
+}
+
+extern "C" bool wt9011_save_settings() {
+    return send_command(wt9011::kCommandSaveSettings, "Save settings");
+}
+
+extern "C" bool wt9011_factory_reset() {
+    return send_command(wt9011::kCommandFactoryReset, "Factory reset");
+}
+
+extern "C" bool wt9011_sleep() {
+    return send_command(wt9011::kCommandSleep, "Sleep");
+}
+
+extern "C" bool wt9011_wakeup() {
+    return send_command(wt9011::kCommandWakeup, "Wakeup");
 }
 
 extern "C" bool wt9011_set_return_rate(int rate_hz) {
-    try {
-        py::gil_scoped_acquire acquire;
-        py::bytes command = commands_class.attr("build_command_set_return_rate")(rate_hz);
-        run_coroutine_void(ble_manager_instance.attr("send")(command));
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Set return rate failed: " << e.what() << std::endl;
+    if (!wt9011::is_valid_return_rate(rate_hz)) {
+        WT9011_LOG_ERROR("Return rate must be 1-100 Hz, got %d", rate_hz);
         return false;
     }
+    return send_command(wt9011::command_set_return_rate(rate_hz), "Set return rate");
 }
 
 extern "C" bool wt9011_accel_enable(bool enable) {
-    try {
-        py::gil_scoped_acquire acquire;
-        py::bytes command = commands_class.attr("build_command_accel_enable")(enable);
-        run_coroutine_void(ble_manager_instance.attr("send")(command));
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Accel enable failed: " << e.what() << std::endl;
-        return false;
-    }
+    return send_command(wt9011::command_accel_enable(enable), "Accel enable");
 }
 
 extern "C" bool wt9011_gyro_enable(bool enable) {
-    try {
-        py::gil_scoped_acquire acquire;
-        py::bytes command = commands_class.attr("build_command_gyro_enable")(enable);
-        run_coroutine_void(ble_manager_instance.attr("send")(command));
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Gyro enable failed: " << e.what() << std::endl;
-        return false;
-    }
+    return send_command(wt9011::command_gyro_enable(enable), "Gyro enable");
 }
 
 extern "C" void wt9011_cleanup() {
-    std::cout << "[INFO] Cleaning up Python environment" << std::endl;
+    WT9011_LOG_INFO("Cleaning up Python environment");
+
+    wt9011_record_stop();
+
+    // Возвращаем GIL потоку инициализации и останавливаем цикл asyncio
+    gil_release.reset();
+    wt9011::close_all_sessions();
+    default_session = nullptr;
+    wt9011::io_loop().stop();
 
     try {
         if (ble_manager_instance) {
@@ -415,14 +439,14 @@ extern "C" void wt9011_cleanup() {
             ble_manager_instance = py::object();
         }
     } catch (...) {
-        std::cerr << "[WARNING] Error cleaning up BLE manager" << std::endl;
+        WT9011_LOG_WARN("Error cleaning up BLE manager");
     }
 
     parser_class = py::object();
-    commands_class = py::object();
-    global_callback = nullptr;
 
     if (guard) {
         guard.reset();
     }
+
+    wt9011::log::shutdown();
 }
\ No newline at end of file
@@ -9,31 +9,37 @@
 #include <stdexcept>
 #include <memory>
 #include <fmt/format.h>
+#include "wt9011_types.h"
+#include "wt9011_api.h"
 
 namespace py = pybind11;
 
-struct DeviceInfo {
-    std::string name;
-    std::string address;
-};
-
-struct SensorData {
-    struct Accel { float x, y, z; };
-    struct Gyro { float x, y, z; };
-    struct Angle { float roll, pitch, yaw; };
-    Accel accel;
-    Gyro gyro;
-    Angle angle;
-};
-
 using DataCallback = void(*)(const SensorData*);
+using SampleCallback = void(*)(const SensorSample*);
 
 extern "C" bool wt9011_init();
 extern "C" bool wt9011_scan(DeviceInfo* devices, int* count, float timeout);
 extern "C" bool wt9011_connect(const char* address);
 extern "C" bool wt9011_receive(DataCallback callback);
+extern "C" bool wt9011_receive_samples(SampleCallback callback);
+extern "C" size_t wt9011_poll(SensorData* out, size_t max);
+extern "C" size_t wt9011_poll_samples(SensorSample* out, size_t max);
+extern "C" unsigned long long wt9011_dropped_samples();
+extern "C" unsigned long long wt9011_discarded_bytes();
 extern "C" bool wt9011_send(const unsigned char* command, int length);
 extern "C" bool wt9011_disconnect();
+extern "C" bool wt9011_record_start(const char* path);
+extern "C" bool wt9011_record_stop();
+extern "C" bool wt9011_capture_start(const char* path);
+extern "C" bool wt9011_capture_stop();
+extern "C" bool wt9011_replay(const char* path, double speed);
+extern "C" wt9011_op* wt9011_connect_async(const char* address);
+extern "C" wt9011_op* wt9011_send_async(const unsigned char* command, int length);
+extern "C" wt9011_op* wt9011_disconnect_async();
+extern "C" bool wt9011_write_register(unsigned char reg, unsigned short value);
+extern "C" bool wt9011_read_register(unsigned char reg, unsigned short* value, int timeout_ms);
+extern "C" bool wt9011_set_windows(const double* seconds, size_t count, double max_rate_hz);
+extern "C" bool wt9011_window_stats(size_t window, WindowStats* out);
 extern "C" bool wt9011_zeroing();
 extern "C" bool wt9011_calibration();
 extern "C" bool wt9011_save_settings();
@@ -45,5 +51,6 @@ extern "C" bool wt9011_accel_enable(bool enable);
 extern "C" bool wt9011_gyro_enable(bool enable);
 extern "C" void wt9011_cleanup();
 extern "C" SensorData convert_to_sensor_data(py::dict data);
+extern "C" int wt9011_decode_batch(const unsigned char* frames, int count, const SensorDataSoA* out);
 
 #endif // WT9011_INTERFACE_H
\ No newline at end of file
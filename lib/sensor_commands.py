@@ -2,37 +2,44 @@
 # Расширенный модуль с командами для WT9011
 
 class WT9011Commands:
-    """Команды управления датчиком WT9011"""
+    """Команды управления датчиком WT9011: запись регистра FF AA reg lo hi"""
+
+    @staticmethod
+    def build_command_write_register(register: int, value: int) -> bytes:
+        """Записать 16-битное значение в любой регистр"""
+        if not (0 <= register <= 0xFF and 0 <= value <= 0xFFFF):
+            raise ValueError("Регистр 0-255, значение 0-65535")
+        return bytes([0xFF, 0xAA, register, value & 0xFF, value >> 8])
 
     @staticmethod
     def build_command_zeroing() -> bytes:
         """Обнулить текущее положение"""
-        return bytes([0xFF, 0xAA, 0x52, 0x00])
+        return bytes([0xFF, 0xAA, 0x52, 0x00, 0x00])
 
     @staticmethod
     def build_command_calibration() -> bytes:
         """Начать калибровку акселерометра"""
-        return bytes([0xFF, 0xAA, 0x01, 0x00])
+        return bytes([0xFF, 0xAA, 0x01, 0x00, 0x00])
 
     @staticmethod
     def build_command_sleep() -> bytes:
         """Увести устройство в спящий режим"""
-        return bytes([0xFF, 0xAA, 0x06, 0x00])
+        return bytes([0xFF, 0xAA, 0x06, 0x00, 0x00])
 
     @staticmethod
     def build_command_wakeup() -> bytes:
         """Вывести устройство из спящего режима"""
-        return bytes([0xFF, 0xAA, 0x06, 0x01])
+        return bytes([0xFF, 0xAA, 0x06, 0x01, 0x00])
 
     @staticmethod
     def build_command_save_settings() -> bytes:
         """Сохранить текущие настройки в память"""
-        return bytes([0xFF, 0xAA, 0x00, 0x00])
+        return bytes([0xFF, 0xAA, 0x00, 0x00, 0x00])
 
     @staticmethod
     def build_command_factory_reset() -> bytes:
         """Сброс настроек к заводским"""
-        return bytes([0xFF, 0xAA, 0x03, 0x00])
+        return bytes([0xFF, 0xAA, 0x03, 0x00, 0x00])
 
     @staticmethod
     def build_command_set_return_rate(rate_hz: int) -> bytes:
@@ -42,15 +49,15 @@ class WT9011Commands:
         """
         if not (1 <= rate_hz <= 100):
             raise ValueError("Частота должна быть от 1 до 100 Гц")
-        return bytes([0xFF, 0xAA, 0x15, rate_hz])
+        return bytes([0xFF, 0xAA, 0x15, rate_hz, 0x00])
 
     @staticmethod
     def build_command_accel_enable(enable: bool) -> bytes:
         """Включить (True) или выключить (False) акселерометр"""
-        return bytes([0xFF, 0xAA, 0x10, 0x01 if enable else 0x00])
+        return bytes([0xFF, 0xAA, 0x10, 0x01 if enable else 0x00, 0x00])
 
     @staticmethod
     def build_command_gyro_enable(enable: bool) -> bytes:
         """Включить (True) или выключить (False) гироскоп"""
-        return bytes([0xFF, 0xAA, 0x11, 0x01 if enable else 0x00])
+        return bytes([0xFF, 0xAA, 0x11, 0x01 if enable else 0x00, 0x00])
 
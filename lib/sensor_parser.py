@@ -37,11 +37,11 @@ class WT9011Parser:
         """
         Команда: Установить текущие значения как ноль (аксель/гиро).
         """
-        return bytes([0xFF, 0xAA, 0x52, 0x00])
+        return bytes([0xFF, 0xAA, 0x52, 0x00, 0x00])
 
     @staticmethod
     def build_command_calibration() -> bytes:
         """
         Команда: Начать калибровку акселерометра и гироскопа.
         """
-        return bytes([0xFF, 0xAA, 0x01, 0x00])
+        return bytes([0xFF, 0xAA, 0x01, 0x00, 0x00])